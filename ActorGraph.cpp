@@ -15,49 +15,131 @@
 #include <queue>
 #include <stack> 
 #include <climits>
+#include <algorithm>
 #include <utility>
 #include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "ActorGraph.h"
+#include "GraphImage.h"
+#include "Landmarks.h"
 #include "Movie.h"
+#include "SearchEngine.hpp"
 
 using namespace std;
 
+// direction optimizing BFS switches to bottom-up when the frontier has more
+// than 1/BFS_ALPHA of the unexplored edges, and back to top-down when it
+// holds less than 1/BFS_BETA of the actors
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+// smallest chunk of a cast file parsed on a thread of its own
+#define LOAD_CHUNK_MIN (1 << 20)
+
 /**
  * Defaut ActorGraph constructor
  */ 
-ActorGraph::ActorGraph(void) {}
+ActorGraph::ActorGraph(void) : component(NULL), edgeCount(0), image(NULL),
+                               imageEdges(NULL), imageOffsets(NULL),
+                               compactionDone(false) {}
 
 /**
- * ActorGraph destructor
+ * ActorGraph destructor, the arena frees the names and arrays at once
  */ 
 ActorGraph::~ActorGraph(void){
-	for (auto & node : actorSet)
-			delete node;
+	finishCompaction();
+	delete image;
+}
+
+/**
+ * Allocates the per-actor arrays once every actor is known. When actors
+ * are added later the arrays are allocated again at the new size and the
+ * components found so far are carried over.
+ */
+void ActorGraph::allocateState(){
+	int count = names.size();
+	int known = edgeSet.size();
+	int * previous = component;
+	component = arena.allocate<int>(count);
+	for (int actor = 0; actor < count; actor++)
+		component[actor] = (actor < known) ? previous[actor] : actor;
+	edgeSet.resize(count);
+	deltaSet.resize(count);
+	initialize(state);
 }
 
 /**
- * Initializes node fields, distance and prev to correct starting values
+ * Initializes the fields of a search, distance and prev to correct starting
+ * values. A state made for a smaller graph grows first.
+ * Parameters:
+ *      state: Fields to initialize
  */ 
-void ActorGraph:: initialize() {
-	for (auto & actor : actorSet){
-		actor->dist = INT_MAX;
-		actor->prev = -1;
-		actor->done = false;
+void ActorGraph:: initialize(SearchState& state) const {
+	int count = names.size();
+	state.dist.assign(count, INT_MAX);
+	state.prev.assign(count, -1);
+	state.done.assign(count, false);
+	state.wanted.resize(count, state.stamp);
+	state.startBudget();
+}
+
+/**
+ * Starts the limits of a new search: no actor expanded yet, the deadline
+ * timeLimit from now
+ */
+void SearchState::startBudget(){
+	expanded = 0;
+	exceeded = false;
+	checkAt = LONG_MAX;
+	if (timeLimit > chrono::steady_clock::duration::zero()) {
+		deadline = chrono::steady_clock::now() + timeLimit;
+		checkAt = BUDGET_CLOCK_INTERVAL;
 	}
+	if (maxExpansions > 0)
+		checkAt = min(checkAt, maxExpansions + 1);
+}
+
+/**
+ * Checks the limits, sets exceeded once one of them is hit and otherwise
+ * moves checkAt to the next expansion they have to be checked at
+ *
+ * Return: true if the search has to stop
+ */
+bool SearchState::overBudget(){
+	if (maxExpansions > 0 && expanded > maxExpansions)
+		exceeded = true;
+	else if (timeLimit > chrono::steady_clock::duration::zero()) {
+		if (chrono::steady_clock::now() >= deadline)
+			exceeded = true;
+		checkAt = expanded + BUDGET_CLOCK_INTERVAL;
+		if (maxExpansions > 0)
+			checkAt = min(checkAt, maxExpansions + 1);
+	}
+	return exceeded;
 }
 
 /** 
- * Locates ActorNode inside the graph given the name of the actor
+ * Locates an actor inside the graph given the name of the actor
  * Parameters:
  *      name: Name of actor
  *
  * Return: Index of actor     
  */ 
-int ActorGraph:: locateActor ( string name ){
-    for (ActorNode *& actor : actorSet){
-        if (actor->actor_name == name)
-            return actor->index;
-    }
+int ActorGraph:: locateActor ( string name ) const {
+    if (image)
+        return image->find(name);
+    auto found = nameIndex.find(name);
+    if (found == nameIndex.end())
+        return -1;
+    return found->second;
 }
 
 
@@ -66,68 +148,164 @@ int ActorGraph:: locateActor ( string name ){
  * Parameters:
  *      fromActor: index of Actor to print connection from
  *      toActor: index of Actor connected to fromActor
- *      outfile: Stream to output results
+ *      outfile: Buffer to format the results into
  *      use_weighted_edges: Use dijkstra or BFS 
+ *      maxYear: Only movies released up to this year link actors
+ *      rootedAtTo: The last search started from toActor instead
  *
  */
 void ActorGraph::printConnections (int fromActor, int toActor, 
-                                ofstream& outfile, bool use_weighted_edges){
+                   OutputBuffer& outfile, bool use_weighted_edges, int maxYear,
+                                                             bool rootedAtTo){
+    printConnections(state, fromActor, toActor, outfile, use_weighted_edges,
+                                                         maxYear, rootedAtTo);
+}
 
-    ActorNode * from = actorSet[fromActor]; // locate the starting vertex
-    int fromIndex = from->index;               // index of the starting vertex
-    ActorNode * to = actorSet[toActor];     // locate the ending vertex
+/**
+ * Prints the connection found by a search run on the given fields
+ * Parameters:
+ *      state: Fields of the search that ran
+ *      fromActor: index of Actor to print connection from
+ *      toActor: index of Actor connected to fromActor
+ *      outfile: Buffer to format the results into
+ *      use_weighted_edges: Use dijkstra or BFS 
+ *      maxYear: Only movies released up to this year link actors
+ *      rootedAtTo: The search started from toActor instead
+ *
+ */
+void ActorGraph::printConnections (const SearchState& state, int fromActor,
+                   int toActor, OutputBuffer& outfile, bool use_weighted_edges,
+                                        int maxYear, bool rootedAtTo) const {
 
-    stack<ActorNode *> explore; // use stack to reverse path traversal to print
+    const int * prev = state.prev.data();
+    stack<int> explore; // use stack to reverse path traversal to print
 
-    explore.push(to);
-	
-	// validity check for connectedness
-	if ( to->prev == -1)
-		outfile << "Actors/actresses not connected!\n";
+    if (!settled(state, fromActor, toActor, use_weighted_edges, rootedAtTo)){
+        outfile << "Search budget exceeded!\n";
+        return;
+    }
 
-    // going back from the fromActor to toActor
-    ActorNode * current = to;
-    while ( current->prev != fromIndex ){
-        explore.push(actorSet[current->prev]);
-        current = actorSet[current->prev];
+    if (rootedAtTo){
+        // the prev links already lead from fromActor to toActor
+        if ( prev[fromActor] == -1 ){
+            outfile << "Actors/actresses not connected!\n";
+            return;
+        }
+        vector<int> path;
+        for (int current = fromActor; current != toActor;
+                                                    current = prev[current])
+            path.push_back(current);
+        explore.push(toActor);
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+            explore.push(*it);
     }
-    explore.push(from);
+    else{
+        // validity check for connectedness
+        if ( toActor != fromActor && prev[toActor] == -1 ){
+            outfile << "Actors/actresses not connected!\n";
+            return;
+        }
 
-    Movie movie; // Movie object
+        // going back from the toActor to fromActor
+        for (int current = toActor; current != fromActor;
+                                                    current = prev[current])
+            explore.push(current);
+        explore.push(fromActor);
+    }
 
-   
-   // Printing the order of movies linking actors in reverse with stack
-   while ( explore.size() > 1){
-        ActorNode * curr = explore.top();
+    // the stack holds the path from fromActor on top to toActor
+    vector<int> path;
+    while ( !explore.empty() ){
+        path.push_back(explore.top());
         explore.pop();
-        ActorNode * next = explore.top();
+    }
+    printPath(path, outfile, use_weighted_edges, maxYear);
+}
+
+/**
+ * Whether a search settled the connection of two actors. A BFS reaches an
+ * actor on a shortest path the first time, while Dijkstra and A* only
+ * settle it once it is popped, so a path to an actor they reached but did
+ * not settle may still get shorter.
+ * Parameters:
+ *      state: Fields of the search that ran
+ *      fromActor: index of Actor the connection starts from
+ *      toActor: index of Actor the connection ends at
+ *      use_weighted_edges: The search was Dijkstra or A*
+ *      rootedAtTo: The search started from toActor instead
+ *
+ * Return: true if printConnections prints a path or no connection
+ */
+bool ActorGraph::settled(const SearchState& state, int fromActor,
+                         int toActor, bool use_weighted_edges,
+                                                    bool rootedAtTo) const {
+    if (!state.exceeded || fromActor == toActor)
+        return true;
+    int reached = rootedAtTo ? fromActor : toActor;
+    if (use_weighted_edges ? state.done[reached] : state.prev[reached] != -1)
+        return true;
+    return componentOf(fromActor) != componentOf(toActor);
+}
+
+/**
+ * Prints a path of actors and the movies linking each consecutive pair
+ * in the format of printConnections. A pair sharing no movie prints a
+ * line naming it instead of the path.
+ * Parameters:
+ *      path: indices of the Actors on the path, in order
+ *      outfile: Buffer to format the results into
+ *      use_weighted_edges: Link actors with their newest shared movie
+ *      maxYear: Only movies released up to this year link actors
+ *
+ */
+void ActorGraph::printPath (const vector<int>& path, OutputBuffer& outfile,
+                                   bool use_weighted_edges, int maxYear) const {
+
+    vector<int> movies; // index of the Movie linking each pair
+
+    // every hop is resolved first, so a path with a pair sharing no movie
+    // prints one line saying so instead of a broken chain
+    for (int i = 0; i + 1 < (int)path.size(); i++){
+        int curr = path[i];
+        int next = path[i + 1];
+        int movie = -1;
 
-        outfile << "(" << curr->actor_name << ")" << "--";
 		if (use_weighted_edges){
-			Movie max={"", 0}; 
-			for (pair<int,Movie>& pairs : curr->edgeSet){
-				if (pairs.first == next->index){
-					if (pairs.second.movie_year > max.movie_year)
-						movie = pairs.second;
-						max = movie;
+			// the newest shared movie is the lightest edge; of several
+			// in that year the first listed one is printed
+			int max = INT_MIN;
+			for (const ActorEdge& edge : edgesOf(curr, maxYear)){
+				if (edge.actor == next && (movie < 0 || edge.year > max)){
+					movie = edge.movie;
+					max = edge.year;
 				}
 			}
 
 		}
 		else{
-			for (pair<int,Movie>& pairs : curr->edgeSet){
-				if (pairs.first == next->index){
-					movie = pairs.second;
+			for (const ActorEdge& edge : edgesOf(curr, maxYear)){
+				if (edge.actor == next){
+					movie = edge.movie;
 					break;
 				}
 			}
         }
 
-        outfile << "[" << movie.movie_title << "#@" 
-                                                << movie.movie_year << "]-->";
+        if (movie < 0){
+            outfile << "No movie links (" << names[curr] << ") and ("
+                    << names[next] << ")!\n";
+            return;
+        }
+        movies.push_back(movie);
+    }
 
+   // Printing the order of movies linking actors
+   for (int i = 0; i + 1 < (int)path.size(); i++){
+        outfile << "(" << names[path[i]] << ")" << "--";
+        outfile << "[" << titleOf(movies[i]) << "#@" << yearOf(movies[i])
+                << "]-->";
     }
-    outfile << "(" << actorSet[toActor]->actor_name << ")\n";
+    outfile << "(" << names[path.back()] << ")\n";
 
 }
 
@@ -135,41 +313,382 @@ void ActorGraph::printConnections (int fromActor, int toActor,
 /** 
  * Creates the edges and fills the member fields of each node inside 
  * the map such that nodes are connected with the shortest unweighted
- *  distances
+ * distances. The search is direction optimizing: it expands the frontier
+ * top-down while it is small and switches to bottom-up, where every
+ * unvisited actor looks for a parent in the frontier bitmap, once the
+ * frontier edges outweigh the unexplored edges.
  *  Parameters:
  *      fromActor: index of Actor to start BFS traversal from
  *      toActor: index of Actor connected to fromActor
+ *      maxYear: Only movies released up to this year link actors. The
+ *               edgeSets are sorted by year, so each scan stops at the
+ *               first later movie.
+ *
+ */ 
+void ActorGraph::BFSTraversal(int fromActor, int toActor, int maxYear){
+    BFSTraversal(fromActor, vector<int>(1, toActor), maxYear);
+}
+
+/**
+ * Marks the actors a search has to reach before it may stop. A target in
+ * another component can never be reached and is not marked, so a search
+ * whose targets are all elsewhere stops before it starts.
+ * Parameters:
+ *      fromActor: index of Actor the search starts from, never marked
+ *      targets: indices of Actors to reach
+ *
+ * Return: Number of distinct targets other than fromActor
+ */
+int ActorGraph::markTargets(SearchState& state, int fromActor,
+                                          const vector<int>& targets) const {
+    int * wanted = state.wanted.data();
+    int searchStamp = ++state.stamp;
+    int count = 0;
+    int source = componentOf(fromActor);
+    for (int target : targets) {
+        if (target != fromActor && wanted[target] != searchStamp &&
+                                              componentOf(target) == source) {
+            wanted[target] = searchStamp;
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Connected component of an actor over every edge added so far. The
+ * up-tree is only read, and createGraph and loadDelta leave every actor
+ * pointing straight at its root, so the lookup is a single read.
+ * Parameters:
+ *      actor: index of Actor
+ *
+ * Return: Index of the actor representing the component
+ */
+int ActorGraph::componentOf(int actor) const {
+    while (component[actor] != actor)
+        actor = component[actor];
+    return actor;
+}
+
+/**
+ * Root of an actor's component, halving the path on the way
+ * Parameters:
+ *      actor: index of Actor
+ *
+ * Return: Index of the actor representing the component
+ */
+int ActorGraph::findComponent(int actor){
+    while (component[actor] != actor) {
+        component[actor] = component[component[actor]];
+        actor = component[actor];
+    }
+    return actor;
+}
+
+/**
+ * Joins the components of two actors, the lower root becomes the root
+ * Parameters:
+ *      left: index of an Actor
+ *      right: index of an Actor sharing a movie with left
+ *
+ */
+void ActorGraph::joinComponents(int left, int right){
+    left = findComponent(left);
+    right = findComponent(right);
+    if (left < right)
+        component[right] = left;
+    else if (right < left)
+        component[left] = right;
+}
+
+/** 
+ * Direction optimizing BFS that stops once every target has been reached.
+ * The BFS tree of a source does not depend on where the search stops, so
+ * each target gets the same path a search for it alone would find.
+ *  Parameters:
+ *      fromActor: index of Actor to start BFS traversal from
+ *      targets: indices of Actors to reach, empty to reach every actor
+ *      maxYear: Only movies released up to this year link actors
  *
  */ 
-void ActorGraph::BFSTraversal(int fromActor, int toActor){
-
-	initialize();			// initialize the dist to infinity and prev to -1
-    ActorNode * from = actorSet[fromActor]; // starting ActorNode 
-    queue<ActorNode *> explore;                // queue to do BFS
-    from->dist = 0;              // initialize starting ActorNode's dist field
-    explore.push(from);            // push the starting ActorNode to the queue
-
-    //perform the breath first search
-    while (!explore.empty() ) {
-       
-       ActorNode * curr = explore.front();
-       explore.pop(); 
-       auto it = curr->edgeSet.begin(); 
-       for ( ; it != curr->edgeSet.end(); ++it) {
-           ActorNode* neighbor = actorSet[it->first];
-           // make sure no cycles
-           if (curr->dist + 1 < neighbor->dist){
-               neighbor->dist = curr->dist + 1;
-               neighbor->prev = curr->index;
-               explore.push(neighbor);
-           }
-		   
-		   // Returns from method once neighboring actor matches 
-		   if (neighbor->actor_name == actorSet[toActor]->actor_name){
-			   return;
-		   }
-       }    
-    }   
+void ActorGraph::BFSTraversal(int fromActor, const vector<int>& targets,
+                                                                int maxYear){
+    BFSTraversal(state, fromActor, targets, maxYear);
+}
+
+/** 
+ * Multi target BFS writing to the given search fields only
+ *  Parameters:
+ *      state: Fields of the search
+ *      fromActor: index of Actor to start BFS traversal from
+ *      targets: indices of Actors to reach, empty to reach every actor
+ *      maxYear: Only movies released up to this year link actors
+ *
+ */ 
+void ActorGraph::BFSTraversal(SearchState& state, int fromActor,
+                            const vector<int>& targets, int maxYear) const {
+
+	initialize(state);		// initialize the dist to infinity and prev to -1
+    int * dist = state.dist.data();
+    int * prev = state.prev.data();
+    int size = names.size();
+    dist[fromActor] = 0;         // initialize starting actor's dist field
+    int remaining = markTargets(state, fromActor, targets); // not reached
+    const int * wanted = state.wanted.data();
+    int searchStamp = state.stamp;
+    if (targets.empty())
+        remaining = -1;
+    if (remaining == 0)
+        return;
+
+    vector<int> frontier(1, fromActor); // current level, top-down
+    vector<int> next;                   // next level, top-down
+    vector<uint64_t> frontierBits;      // current level, bottom-up
+    vector<uint64_t> nextBits;          // next level, bottom-up
+    int frontierSize = 1;               // actors in the current level
+    long frontierEdges = degreeOf(fromActor); // edges out of the level
+    long unexploredEdges = edgeCount - frontierEdges; // edges out of the rest
+    bool bottomUp = false;              // direction of the current step
+    int level = 0;                      // distance of the current level
+
+    //perform the breath first search one level at a time
+    while (frontierSize > 0) {
+
+        // pick the direction for this level
+        if (!bottomUp && frontierEdges > unexploredEdges / BFS_ALPHA) {
+            bottomUp = true;
+            frontierBits.assign((size + 63) / 64, 0);
+            for (int index : frontier)
+                frontierBits[index >> 6] |= (uint64_t)1 << (index & 63);
+        }
+        else if (bottomUp && frontierSize < size / BFS_BETA) {
+            bottomUp = false;
+            frontier.clear();
+            for (int index = 0; index < size; index++) {
+                if (frontierBits[index >> 6] >> (index & 63) & 1)
+                    frontier.push_back(index);
+            }
+        }
+
+        frontierSize = 0;
+        frontierEdges = 0;
+
+        if (!bottomUp) {
+            // every actor in the frontier claims its unvisited neighbors
+            next.clear();
+            for (int index : frontier) {
+                if (state.expand())
+                    return;
+                for (const ActorEdge& edge : edgesOf(index, maxYear)) {
+                    int neighbor = edge.actor;
+                    if (dist[neighbor] != INT_MAX)
+                        continue;
+                    dist[neighbor] = level + 1;
+                    prev[neighbor] = index;
+                    next.push_back(neighbor);
+                    frontierEdges += degreeOf(neighbor);
+
+                    // Returns from method once the last target is reached
+                    if (wanted[neighbor] == searchStamp && --remaining == 0)
+                        return;
+                }
+            }
+            frontier.swap(next);
+            frontierSize = frontier.size();
+        }
+        else {
+            // the targets look for a parent first, the level is finished
+            // early when the last one has one in the frontier
+            nextBits.assign(frontierBits.size(), 0);
+            for (int target : targets) {
+                if (wanted[target] != searchStamp || dist[target] != INT_MAX)
+                    continue;
+                if (state.expand())
+                    return;
+                for (const ActorEdge& edge : edgesOf(target, maxYear)) {
+                    int parent = edge.actor;
+                    if (frontierBits[parent >> 6] >> (parent & 63) & 1) {
+                        dist[target] = level + 1;
+                        prev[target] = parent;
+                        if (--remaining == 0)
+                            return;
+                        nextBits[target >> 6] |= (uint64_t)1 << (target & 63);
+                        frontierSize++;
+                        frontierEdges += degreeOf(target);
+                        break;
+                    }
+                }
+            }
+
+            // every unvisited actor looks for a parent in the frontier
+            for (int index = 0; index < size; index++) {
+                if (dist[index] != INT_MAX)
+                    continue;
+                if (state.expand())
+                    return;
+                for (const ActorEdge& edge : edgesOf(index, maxYear)) {
+                    int parent = edge.actor;
+                    if (frontierBits[parent >> 6] >> (parent & 63) & 1) {
+                        dist[index] = level + 1;
+                        prev[index] = parent;
+                        if (wanted[index] == searchStamp && --remaining == 0)
+                            return;
+                        nextBits[index >> 6] |= (uint64_t)1 << (index & 63);
+                        frontierSize++;
+                        frontierEdges += degreeOf(index);
+                        break;
+                    }
+                }
+            }
+            frontierBits.swap(nextBits);
+        }
+
+        unexploredEdges -= frontierEdges;
+        level++;
+    }
+}
+
+/**
+ * Step a search of a batch takes next. Each one issues the prefetches for
+ * the one after it and hands over to the next search.
+ *      STEP_POP:   takes the next actor, fetches its edge list headers
+ *      STEP_EDGES: fetches the first edges of the actor
+ *      STEP_SCAN:  fetches the distances of the next BATCH_CHUNK co-stars
+ *                  and relaxes the edges of the chunk fetched before
+ */
+enum BatchStep { STEP_POP, STEP_EDGES, STEP_SCAN, STEP_DONE };
+
+// co-stars fetched ahead and relaxed by one step of a batched search
+#define BATCH_CHUNK 64
+
+/**
+ * One top-down BFS of a batch, kept between its steps
+ */
+struct BatchSearch{
+    SearchState * state;    // fields and limits of the search
+    int * dist;             // distance field of the search
+    int * prev;             // previous actor field of the search
+    const int * wanted;     // targets hold the stamp of the search
+    int stamp;              // stamp of the search
+    vector<int> queue;      // every actor reached, in order
+    size_t head;            // next actor of the queue to expand
+    int actor;              // actor being expanded
+    int remaining;          // targets not reached yet, -1 for none
+    BatchStep step;         // step to take next
+    EdgeRange::iterator scan;   // next edge of the actor to relax
+    EdgeRange::iterator ahead;  // next edge whose co-star to fetch
+};
+
+/** 
+ * Runs a batch of top-down BFS searches interleaved on one thread. The
+ * relaxation is the one of search with a FifoQueue, so each search stops
+ * and sets its fields the same way.
+ *  Parameters:
+ *      states: Fields of each search, at least one per root
+ *      roots: index of the Actor each search starts from
+ *      targets: indices of Actors each search has to reach
+ *      maxYear: Only movies released up to this year link actors
+ *
+ */
+void ActorGraph::BFSBatch(vector<SearchState>& states,
+                          const vector<int>& roots,
+                          const vector<vector<int>>& targets,
+                          int maxYear) const {
+    int count = roots.size();
+    vector<BatchSearch> batch(count);
+    int active = 0;                     // searches not done yet
+    for (int i = 0; i < count; i++) {
+        BatchSearch& search = batch[i];
+        initialize(states[i]);
+        states[i].dist[roots[i]] = 0;
+        search.remaining = markTargets(states[i], roots[i], targets[i]);
+        search.state = &states[i];
+        search.dist = states[i].dist.data();
+        search.prev = states[i].prev.data();
+        search.wanted = states[i].wanted.data();
+        search.stamp = states[i].stamp;
+        if (targets[i].empty())
+            search.remaining = -1;
+        search.queue.assign(1, roots[i]);
+        search.head = 0;
+        search.step = search.remaining ? STEP_POP : STEP_DONE;
+        active += search.step != STEP_DONE;
+    }
+
+    EdgeRange::iterator last;           // end of every edge list
+    while (active > 0) {
+        for (BatchSearch& search : batch) {
+            int actor = search.actor;
+            switch (search.step) {
+            case STEP_POP:
+                if (search.head == search.queue.size() ||
+                                                   search.state->expand()) {
+                    search.step = STEP_DONE;
+                    active--;
+                    break;
+                }
+                actor = search.actor = search.queue[search.head++];
+                if (image)
+                    __builtin_prefetch(imageOffsets + actor);
+                else {
+                    __builtin_prefetch(&edgeSet[actor]);
+                    __builtin_prefetch(&deltaSet[actor]);
+                }
+                search.step = STEP_EDGES;
+                break;
+
+            case STEP_EDGES:
+                if (image)
+                    __builtin_prefetch(imageEdges + imageOffsets[actor]);
+                else {
+                    __builtin_prefetch(edgeSet[actor].data());
+                    __builtin_prefetch(deltaSet[actor].data());
+                }
+                search.scan = search.ahead = edgesOf(actor, maxYear).begin();
+                search.step = STEP_SCAN;
+                break;
+
+            case STEP_SCAN: {
+                // the first edges may not have arrived yet, so the first
+                // scan only fetches; later ones relax what was fetched
+                // before and fetch the next chunk meanwhile
+                EdgeRange::iterator& scan = search.scan;
+                EdgeRange::iterator& ahead = search.ahead;
+                bool fetched = scan != ahead || !(ahead != last);
+                for (int i = 0; i < BATCH_CHUNK && ahead != last; i++) {
+                    __builtin_prefetch(search.dist + (*ahead).actor);
+                    ++ahead;
+                }
+                if (!fetched)
+                    break;
+
+                int * dist = search.dist;
+                int distance = dist[actor] + 1;
+                for (int i = 0; i < BATCH_CHUNK && scan != last; i++) {
+                    int neighbor = (*scan).actor;
+                    ++scan;
+                    if (distance >= dist[neighbor])
+                        continue;
+                    search.prev[neighbor] = actor;
+                    dist[neighbor] = distance;
+                    if (search.wanted[neighbor] == search.stamp &&
+                                                  --search.remaining == 0) {
+                        search.step = STEP_DONE;
+                        active--;
+                        break;
+                    }
+                    search.queue.push_back(neighbor);
+                }
+                if (search.step == STEP_SCAN && !(scan != last))
+                    search.step = STEP_POP;
+                break;
+            }
+
+            case STEP_DONE:
+                break;
+            }
+        }
+    }
 }
 
 /** 
@@ -178,59 +697,363 @@ void ActorGraph::BFSTraversal(int fromActor, int toActor){
  * distances
  * Parameters:
  *      fromActor: index of Actor to start Dijkstra traversal from
+ *      toActor: index of Actor connected to fromActor, or -1 to compute
+ *               the distance of every actor
+ *      maxYear: Only movies released up to this year link actors
+ *
+ */
+void ActorGraph::Dijkstra(int fromActor, int toActor, int maxYear){
+	search<HeapQueue>(fromActor, toActor, maxYear, RecencyWeight(),
+	                                                          NoHeuristic());
+}
+
+/** 
+ * Dijkstra that stops once every target is settled. Settled distances and
+ * previous actors do not depend on where the search stops, so each target
+ * gets the same path a search for it alone would find.
+ * Parameters:
+ *      fromActor: index of Actor to start Dijkstra traversal from
+ *      targets: indices of Actors to settle, empty to settle every actor
+ *      maxYear: Only movies released up to this year link actors
+ *
+ */
+void ActorGraph::Dijkstra(int fromActor, const vector<int>& targets,
+                                                               int maxYear){
+	search<HeapQueue>(fromActor, targets, maxYear, RecencyWeight(),
+	                                                          NoHeuristic());
+}
+
+/** 
+ * Goal directed version of Dijkstra. The queue is ordered by the distance
+ * plus the landmark lower bound on the distance left to toActor. The bound
+ * is consistent, so an actor is final the first time it is popped and the
+ * path found is as short as the one Dijkstra finds.
+ * Parameters:
+ *      fromActor: index of Actor to start A* search from
  *      toActor: index of Actor connected to fromActor
+ *      landmarks: Landmark distances built over this graph
+ *      maxYear: Only movies released up to this year link actors
  *
  */
-void ActorGraph::Dijkstra(int fromActor, int toActor){
+void ActorGraph::AStar(int fromActor, int toActor, 
+                               const Landmarks& landmarks, int maxYear){
+	search<HeapQueue>(fromActor, toActor, maxYear, RecencyWeight(),
+	                                 LandmarkHeuristic(landmarks, toActor));
+}
 
-	initialize();           // Initializes node fields to default values
-    ActorNode * from = actorSet[fromActor]; // start Node to search from
-	priority_queue<pair <int,int>,vector<pair<int,int>>, ActorNodeComp> pqueue;
-	pqueue.push(make_pair(from->index, 0));
-    
-    // perform DIjstra algorithm
-	while (!pqueue.empty()){
-		int curr = pqueue.top().first;
-		pqueue.pop();
-		
-		if (! (actorSet[curr]->done)){
-			actorSet[curr]->done = true;
-			for (auto & pair : actorSet[curr]->edgeSet){
-				int neighbor = pair.first;
-				int weight = 2016 - pair.second.movie_year;
-				int distance = actorSet[curr]->dist + weight;
-				if (distance < actorSet[neighbor]->dist){
-					actorSet[neighbor]->prev = curr;
-					actorSet[neighbor]->dist = distance;
-					pqueue.push(make_pair(neighbor, distance));
-				}
-			}
-			if (actorSet[curr]->actor_name == actorSet[toActor]->actor_name)
-				return;
-		}
-	}
-	
+/**
+ * Distance of an actor found by the last traversal
+ * Parameters:
+ *      actor: index of Actor
+ *
+ * Return: Distance from the source, INT_MAX if it was not reached
+ */
+int ActorGraph::distanceTo(int actor){
+	return state.dist[actor];
+}
 
+/**
+ * Number of edges leaving an actor, one per co-star per movie
+ * Parameters:
+ *      actor: index of Actor
+ *
+ * Return: Size of the actor's edgeSet
+ */
+int ActorGraph::degreeOf(int actor) const {
+	if (image)
+		return imageOffsets[actor + 1] - imageOffsets[actor];
+	return edgeSet[actor].size() + deltaSet[actor].size();
 }
 
+/**
+ * Fills a compressed copy of the graph for read only traversals. Repeated
+ * co-stars are dropped, keeping the first occurrence in edgeSet order.
+ * Parameters:
+ *      adjacency: Adjacency to fill
+ *      weighted: Also store the lowest 2016 - year weight of the movies two
+ *                co-stars share
+ *
+ */
+void ActorGraph::buildAdjacency(Adjacency& adjacency, bool weighted){
+    int size = names.size();
+    vector<int> position(size, -1); // where a co-star sits in targets
+
+    adjacency.offsets.assign(1, 0);
+    adjacency.targets.clear();
+    adjacency.weights.clear();
+
+    for (int actor = 0; actor < size; actor++){
+        int begin = adjacency.targets.size();
+        for (const ActorEdge& edge : edgesOf(actor)){
+            int weight = 2016 - edge.year;
+            int slot = position[edge.actor];
+            if (slot >= begin){
+                // co-star seen already, keep the lighter movie
+                if (weighted && weight < adjacency.weights[slot])
+                    adjacency.weights[slot] = weight;
+                continue;
+            }
+            position[edge.actor] = adjacency.targets.size();
+            adjacency.targets.push_back(edge.actor);
+            if (weighted)
+                adjacency.weights.push_back(weight);
+        }
+        adjacency.offsets.push_back(adjacency.targets.size());
+    }
+}
+
+
+/**
+ * Lines of a cast file parsed on one thread, with the actors and movies of
+ * the lines in tables of the chunk's own
+ */
+struct CastChunk{
+    const char * begin;             // first byte of the chunk
+    const char * end;               // byte after the chunk
+    vector<string> actors;          // actors of the chunk, in file order
+    vector<pair<Movie, vector<int>>> movies; // movies in the order first
+                                    // seen, each with its local actors in
+                                    // file order
+    bool valid;                     // every year was a number
+};
+
+/**
+ * Parses the lines of a chunk the way the sequential loader did: a line
+ * is split at every tab, a trailing tab adds no field, and only lines of
+ * exactly 3 fields are kept. A new actor starts wherever the name changes.
+ * The movies of the chunk are found in a table of their own, so a line
+ * makes no string unless its actor or movie is new to the chunk.
+ * Parameters:
+ *      chunk: Chunk to parse
+ *
+ */
+static void parseChunk(CastChunk& chunk){
+    chunk.valid = true;
+    vector<int> slots(1024, -1);        // open addressing table of movies
+    vector<uint64_t> hashes;            // hash of each movie of the chunk
+    const char * field[4];              // start of each field of a line
+    const char * fieldEnd[4];           // end of each field of a line
+    const char * line = chunk.begin;
+    while (line < chunk.end) {
+        const char * stop = (const char *)memchr(line, '\n', chunk.end - line);
+        if (!stop)
+            stop = chunk.end;
+
+        int fields = 0;
+        for (const char * next = line; next < stop && fields < 4; fields++) {
+            const char * tab = (const char *)memchr(next, '\t', stop - next);
+            if (!tab)
+                tab = stop;
+            field[fields] = next;
+            fieldEnd[fields] = tab;
+            next = tab + 1;
+        }
+        line = stop + 1;
+
+        // we should have exactly 3 columns
+        if (fields != 3)
+            continue;
+        size_t nameLength = fieldEnd[0] - field[0];
+        if (chunk.actors.empty() ||
+                chunk.actors.back().size() != nameLength ||
+                memcmp(chunk.actors.back().data(), field[0], nameLength))
+            chunk.actors.push_back(string(field[0], fieldEnd[0]));
+
+        int year;
+        try {
+            year = stoi(string(field[2], fieldEnd[2]));
+        }
+        catch (const logic_error&) {
+            chunk.valid = false;
+            return;
+        }
+
+        // 64 bit FNV-1a hash of the title and the year
+        size_t titleLength = fieldEnd[1] - field[1];
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char * c = field[1]; c < fieldEnd[1]; c++) {
+            hash ^= (unsigned char)*c;
+            hash *= 0x100000001b3ULL;
+        }
+        hash = (hash ^ (uint32_t)year) * 0x100000001b3ULL;
+
+        size_t mask = slots.size() - 1;
+        size_t slot = hash & mask;
+        for (; slots[slot] >= 0; slot = (slot + 1) & mask) {
+            int movie = slots[slot];
+            const Movie & known = chunk.movies[movie].first;
+            if (hashes[movie] == hash && known.movie_year == year &&
+                    known.movie_title.size() == titleLength &&
+                    !memcmp(known.movie_title.data(), field[1], titleLength))
+                break;
+        }
+        if (slots[slot] < 0) {
+            slots[slot] = chunk.movies.size();
+            hashes.push_back(hash);
+            Movie movie = { string(field[1], fieldEnd[1]), year };
+            chunk.movies.push_back(make_pair(movie, vector<int>()));
+
+            // the table is kept at most half full
+            if (2 * chunk.movies.size() > slots.size()) {
+                slots.assign(2 * slots.size(), -1);
+                mask = slots.size() - 1;
+                for (int movie = 0; movie < (int)hashes.size(); movie++) {
+                    size_t free = hashes[movie] & mask;
+                    while (slots[free] >= 0)
+                        free = (free + 1) & mask;
+                    slots[free] = movie;
+                }
+            }
+            chunk.movies.back().second.push_back(chunk.actors.size() - 1);
+        }
+        else
+            chunk.movies[slots[slot]].second.push_back(
+                                                  chunk.actors.size() - 1);
+    }
+}
 
 /** 
- * Load the graph from a tab-delimited file of actor->movie 
- * relationships.
+ * Load the graph from a tab-delimited file of actor->movie relationships.
+ * The file is mapped and split into newline aligned chunks that are parsed
+ * on threads, each into tables of its own actors and movies. The tables
+ * are merged in file order: an actor whose lines span a chunk boundary is
+ * continued, and movies are added to the map in the order they first
+ * appear, so every actor and movie ends up where a line by line read puts
+ * it.
  * Parameters:
  *      in_filename - input filename
+ *      map - set to the indices of the actors of every movie, in order
+ *      threads - threads to parse with, 0 for one per core
  *
  * Return: true if file was loaded sucessfully, false otherwise
  */
 bool ActorGraph::loadFromFile(const char* in_filename,
-                                     unordered_map<Movie,vector<int>>& map) {
+                     unordered_map<Movie,vector<int>>& map, int threads) {
+    // the file is read where it lies, not copied
+    int fd = open(in_filename, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) < 0) {
+        if (fd >= 0)
+            close(fd);
+        cerr << "Failed to read " << in_filename << "!\n";
+        return false;
+    }
+    size_t length = info.st_size;
+    const char * text = NULL;
+    if (length) {
+        void * mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            cerr << "Failed to read " << in_filename << "!\n";
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        text = (const char *)mapped;
+    }
+    close(fd);
+
+    // skip the header
+    const char * begin = text;
+    const char * end = text + length;
+    const char * header = length ? (const char *)memchr(begin, '\n', length)
+                                 : NULL;
+    begin = header ? header + 1 : end;
+
+    // every chunk but the last ends at a newline
+    if (threads <= 0)
+        threads = max((int)thread::hardware_concurrency(), 1);
+    long chunkSize = max((long)(end - begin) / threads, (long)LOAD_CHUNK_MIN);
+    vector<CastChunk> chunks;
+    while (begin < end) {
+        CastChunk chunk;
+        chunk.begin = begin;
+        chunk.valid = true;
+        const char * stop = begin + min(chunkSize, (long)(end - begin));
+        if (stop < end) {
+            stop = (const char *)memchr(stop, '\n', end - stop);
+            stop = stop ? stop + 1 : end;
+        }
+        chunk.end = begin = stop;
+        chunks.push_back(chunk);
+    }
+
+    vector<thread> parsers;
+    for (size_t c = 1; c < chunks.size(); c++)
+        parsers.push_back(thread(parseChunk, ref(chunks[c])));
+    if (!chunks.empty())
+        parseChunk(chunks[0]);
+    for (thread & parser : parsers)
+        parser.join();
+    if (length)
+        munmap((void *)text, length);
+
+    string currentActor; // current actor in the set
+    int counter = names.size(); // index of actor in the set
+    vector<int> index;   // index of each actor of a chunk
+    for (CastChunk & chunk : chunks) {
+        if (!chunk.valid) {
+            cerr << "Failed to read " << in_filename << "!\n";
+            return false;
+        }
+
+        // add the actor to the name array if actor has not appeared yet
+        index.resize(chunk.actors.size());
+        for (size_t actor = 0; actor < chunk.actors.size(); actor++) {
+            if (currentActor != chunk.actors[actor]) {
+                currentActor.swap(chunk.actors[actor]);
+                names.push_back(arena.copy(currentActor));
+                nameIndex.emplace(currentActor, counter);
+                counter++;
+            }
+            index[actor] = counter - 1;
+        }
+
+        // add the actors of each movie of the chunk to the hashmap
+        for (auto & entry : chunk.movies) {
+            vector<int>& cast = map[move(entry.first)];
+            for (int actor : entry.second)
+                cast.push_back(index[actor]);
+        }
+        vector<pair<Movie, vector<int>>>().swap(chunk.movies);
+    }
+
+    allocateState();
+	return true;
+}
+
+/** 
+ * Adds the actors and movies of a delta cast file to a built graph. Actors
+ * and movies already in the graph are matched by name, so a delta may add
+ * actors to an existing movie as well as add new movies. Each new cast
+ * member gets an edge to and from every other member of the movie.
+ * Parameters:
+ *      in_filename - delta file, same format as loadFromFile
+ *
+ * Return: Number of movies added or extended, -1 if the file could not be
+ *         read
+ */
+int ActorGraph::loadDelta(const char* in_filename) {
+    // an attached image is read only
+    if (image)
+        return -1;
+
     // Initialize the file stream
     ifstream infile(in_filename);
+    if (!infile)
+        return -1;
 
-    bool have_header = false;
+    // the compactor reads the deltaSets, it has to be done first
+    finishCompaction();
+    if (movieIndex.size() != movies.size()){
+        movieIndex.clear();
+        for (int movie = 0; movie < (int)movies.size(); movie++)
+            movieIndex.emplace(movies[movie], movie);
+    }
 
-    string currentActor; // current actor in the set
-    int counter = 0; // index of actor in the set
+    int known = names.size();       // actors before the delta
+    vector<int> touched;            // movies the delta adds actors to
+    unordered_map<int, int> castBefore; // cast size before the delta
+    bool have_header = false;
 
     // keep reading lines until the end of file is reached
     while (infile) {
@@ -262,32 +1085,256 @@ bool ActorGraph::loadFromFile(const char* in_filename,
             continue;
         }
 
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
-        
+        // known actors keep their index, new ones are appended
+        int actor;
+        auto found = nameIndex.find(record[0]);
+        if (found != nameIndex.end())
+            actor = found->second;
+        else{
+            actor = names.size();
+            names.push_back(arena.copy(record[0]));
+            nameIndex.emplace(record[0], actor);
+        }
 
-        ActorNode * actor; // the actor in the current movie 
-        // push actor to set of ActorNodes if actor has not appeared in set yet
-        if (currentActor != actor_name){
-            currentActor = actor_name;
-            actor = new ActorNode(actor_name);
-            actor->index = counter;
-            actorSet.push_back(actor);   
-            counter++;
+        Movie movie = {record[1], stoi(record[2])};
+        auto entry = movieIndex.find(movie);
+        int index;
+        if (entry != movieIndex.end())
+            index = entry->second;
+        else{
+            index = movies.size();
+            movies.push_back(movie);
+            movieIndex.emplace(movie, index);
+            casts.push_back(vector<int>());
         }
 
-        // add the <movie, actor> pair into the hashmap
-        Movie movie = {movie_title, movie_year};
-        map[movie].push_back(counter - 1); 
+        vector<int>& cast = casts[index];
+        if (castBefore.find(index) == castBefore.end()){
+            castBefore[index] = cast.size();
+            touched.push_back(index);
+        }
+        if (find(cast.begin(), cast.end(), actor) == cast.end())
+            cast.push_back(actor);
     }
-	
+
     if (!infile.eof()) {
         cerr << "Failed to read " << in_filename << "!\n";
-        return false;
+        return -1;
     }
     infile.close();
-	return true;
+    if ((int)names.size() > known)
+        allocateState();
+
+    // new cast members link to everyone in the movie, in both directions
+    vector<int> changed;            // actors whose deltaSet grew
+    for (int index : touched){
+        vector<int>& cast = casts[index];
+        int before = castBefore[index];
+        int number = cast.size();
+        int year = movies[index].movie_year;
+        for (int i = before; i < number; i++){
+            for (int j = 0; j < number; j++){
+                if (j == i)
+                    continue;
+                ActorEdge edge = { cast[j], index, year };
+                deltaSet[cast[i]].push_back(edge);
+                edgeCount++;
+                if (j < before){
+                    ActorEdge back = { cast[i], index, year };
+                    deltaSet[cast[j]].push_back(back);
+                    edgeCount++;
+                    changed.push_back(cast[j]);
+                }
+            }
+            changed.push_back(cast[i]);
+        }
+        for (int i = 1; i < number; i++)
+            joinComponents(cast[i - 1], cast[i]);
+    }
+
+    // the deltaSets are kept sorted by year like the edgeSets
+    sort(changed.begin(), changed.end());
+    changed.erase(unique(changed.begin(), changed.end()), changed.end());
+    for (int actor : changed){
+        stable_sort(deltaSet[actor].begin(), deltaSet[actor].end(),
+                [](const ActorEdge& lhs, const ActorEdge& rhs){
+            return lhs.year < rhs.year;
+        });
+    }
+
+    // searches on other threads read the components without halving
+    for (int actor = 0; actor < (int)names.size(); actor++)
+        component[actor] = findComponent(actor);
+    return touched.size();
+}
+
+/**
+ * Deep copy of the graph, for building its next version off to the side.
+ * Only edges, names, movies and components are copied; a compaction that
+ * is running keeps merging into this graph.
+ *
+ * Return: New graph, owned by the caller
+ */
+ActorGraph * ActorGraph::clone() const {
+    ActorGraph * copy = new ActorGraph();
+    // an attached image is shared, not copied
+    if (image){
+        copy->attachImage(image->name().c_str());
+        return copy;
+    }
+    int count = names.size();
+    copy->names.reserve(count);
+    for (const char * name : names)
+        copy->names.push_back(copy->arena.copy(name));
+    copy->component = copy->arena.allocate<int>(count);
+    std::copy(component, component + count, copy->component);
+    copy->nameIndex = nameIndex;
+    copy->edgeSet = edgeSet;
+    copy->deltaSet = deltaSet;
+    copy->movies = movies;
+    copy->movieIndex = movieIndex;
+    copy->casts = casts;
+    copy->edgeCount = edgeCount;
+    copy->initialize(copy->state);
+    return copy;
+}
+
+/**
+ * Merges the deltas and writes the graph to a shared image
+ * Parameters:
+ *      name: Segment like "/pa4graph" for POSIX shared memory, any other
+ *            name is a file
+ *
+ * Return: true if the image was written, false otherwise
+ */
+bool ActorGraph::saveImage(const char * name){
+    compact();
+    return GraphImage::save(*this, name);
+}
+
+/**
+ * Maps a shared image instead of loading a cast file. Only the name
+ * pointers and the search fields are allocated per process; edges, names,
+ * components and movies are read from the mapping.
+ * Parameters:
+ *      name: Segment or file the image was written to
+ *
+ * Return: true if the image was attached, false otherwise
+ */
+bool ActorGraph::attachImage(const char * name){
+    if (!names.empty() || image)
+        return false;
+    GraphImage * mapped = new GraphImage();
+    if (!mapped->attach(name)){
+        delete mapped;
+        return false;
+    }
+    image = mapped;
+    int count = image->actors();
+    names.resize(count);
+    for (int actor = 0; actor < count; actor++)
+        names[actor] = image->actorName(actor);
+    // never written once attached, joins only happen while building
+    component = const_cast<int *>(image->components());
+    imageEdges = image->edgeList();
+    imageOffsets = image->edgeOffsets();
+    edgeCount = image->edges();
+    initialize(state);
+    return true;
+}
+
+/**
+ * Number of movies in the movie table
+ *
+ * Return: Number of movies
+ */
+int ActorGraph::movieCount() const {
+    return image ? image->movies() : movies.size();
+}
+
+/**
+ * Title of a movie in the movie table
+ * Parameters:
+ *      movie: index of the Movie
+ *
+ * Return: Title of the movie
+ */
+const char * ActorGraph::titleOf(int movie) const {
+    return image ? image->title(movie) : movies[movie].movie_title.c_str();
+}
+
+/**
+ * Year of a movie in the movie table
+ * Parameters:
+ *      movie: index of the Movie
+ *
+ * Return: Release year of the movie
+ */
+int ActorGraph::yearOf(int movie) const {
+    return image ? image->year(movie) : movies[movie].movie_year;
+}
+
+/**
+ * Merges the deltaSet of every actor that has one into a copy of its
+ * edgeSet, without touching either, so searches may run meanwhile
+ */
+void ActorGraph::mergeDelta(){
+    compacted.clear();
+    int size = deltaSet.size();
+    for (int actor = 0; actor < size; actor++){
+        vector<ActorEdge>& delta = deltaSet[actor];
+        if (delta.empty())
+            continue;
+        vector<ActorEdge>& base = edgeSet[actor];
+        vector<ActorEdge> merged(base.size() + delta.size());
+        merge(base.begin(), base.end(), delta.begin(), delta.end(),
+              merged.begin(), [](const ActorEdge& lhs, const ActorEdge& rhs){
+            return lhs.year < rhs.year;
+        });
+        compacted.push_back(make_pair(actor, vector<ActorEdge>()));
+        compacted.back().second.swap(merged);
+    }
+}
+
+/**
+ * Merges the deltaSets into the edgeSets, on a thread if asked to
+ * Parameters:
+ *      background: Return at once and merge on a thread
+ *
+ */
+void ActorGraph::compact(bool background){
+    finishCompaction();
+    compactionDone = false;
+    compactor = thread([this](){
+        mergeDelta();
+        compactionDone = true;
+    });
+    if (!background)
+        finishCompaction();
+}
+
+/**
+ * Swaps in the edge lists merged by a background compaction. The merged
+ * lists hold the same edges as the edgeSet and deltaSet they replace, in
+ * the order edgesOf visits those.
+ * Parameters:
+ *      wait: Wait for the thread if it is still merging
+ *
+ * Return: true if no compaction is left running, false otherwise
+ */
+bool ActorGraph::finishCompaction(bool wait){
+    if (!compactor.joinable())
+        return true;
+    if (!wait && !compactionDone)
+        return false;
+    compactor.join();
+
+    for (auto & entry : compacted){
+        edgeSet[entry.first].swap(entry.second);
+        vector<ActorEdge>().swap(deltaSet[entry.first]);
+    }
+    compacted.clear();
+    return true;
 }
 
 /**
@@ -299,6 +1346,10 @@ bool ActorGraph::loadFromFile(const char* in_filename,
 void ActorGraph::createGraph(unordered_map<Movie, vector<int>>& map){
     // iterate through the hash map
     for (auto & pair: map){
+        int movie = movies.size();
+        int year = pair.first.movie_year;
+        movies.push_back(pair.first);
+        casts.push_back(pair.second);
         // the set of actors played in this movie
         int number = pair.second.size();
         // connect them all
@@ -308,19 +1359,38 @@ void ActorGraph::createGraph(unordered_map<Movie, vector<int>>& map){
                 // not connect to him/herself
                 if (j != i ){
                     // add edge into the edgeSet of the current actor
-                    actorSet[actorIndex]->edgeSet.push_back(make_pair(
-                                                pair.second[j], pair.first)); 
+                    ActorEdge edge = { pair.second[j], movie, year };
+                    edgeSet[actorIndex].push_back(edge); 
+                    edgeCount++;
                 }
 
             }
         }
 
+        // one chain through the cast joins all of them
+        for (int i = 1; i < number; i++)
+            joinComponents(pair.second[i - 1], pair.second[i]);
+
+    }
+
+    // every actor points straight at the root of its component
+    for (int actor = 0; actor < (int)names.size(); actor++)
+        component[actor] = findComponent(actor);
+
+    // oldest movies first, so a search limited to a year stops scanning an
+    // edgeSet at its first later movie
+    for (vector<ActorEdge>& edges : edgeSet){
+        stable_sort(edges.begin(), edges.end(),
+                [](const ActorEdge& lhs, const ActorEdge& rhs){
+            return lhs.year < rhs.year;
+        });
     }
 }
 
 
 /**
- * Creates graph year by year for actorconnections
+ * Creates graph year by year for actorconnections. Movies have to be added
+ * in order of year to keep every edgeSet sorted by year.
  * Parameters:
  *      map: Map with pairs of Movie and vector of Actor indices
  *      movie: Movie reference to connect actors who acted in it
@@ -331,6 +1401,9 @@ void ActorGraph::createGraph(unordered_map<Movie, vector<int>>& map,
         // the set of actors played in this movie
 		auto actors = map[*movie];
         int number = actors.size();
+        int index = movies.size();
+        movies.push_back(*movie);
+        casts.push_back(actors);
         // connect them all
         for (int i = 0; i < number; i++){
             int actorIndex = actors[i];
@@ -338,13 +1411,125 @@ void ActorGraph::createGraph(unordered_map<Movie, vector<int>>& map,
                 // not connect to him/herself
                 if (j != i ){
                     // add edge into the edgeSet of the current actor
-                    actorSet[actorIndex]->edgeSet.push_back(make_pair(
-                                                        actors[j], *movie)); 
+                    ActorEdge edge = { actors[j], index, movie->movie_year };
+                    edgeSet[actorIndex].push_back(edge); 
+                    edgeCount++;
                 }
 
             }
         }
+        for (int i = 1; i < number; i++)
+            joinComponents(actors[i - 1], actors[i]);
+
+}
+
+/**
+ * Computes the permutation used by reorder without applying it
+ * Parameters:
+ *      order: Ordering strategy to compute
+ *
+ * Return: Vector where entry i holds the old index of the actor that is
+ *         placed at index i
+ */
+vector<int> ActorGraph::computeOrder(ActorOrder order){
+    int size = names.size();
+    vector<int> result(size);
+    for (int i = 0; i < size; i++)
+        result[i] = i;
+
+    if (order == ORDER_DEGREE){
+        // hubs first, ties stay in file order
+        stable_sort(result.begin(), result.end(), [this](int lhs, int rhs){
+            return edgeSet[lhs].size() > edgeSet[rhs].size();
+        });
+    }
+    else if (order == ORDER_RCM){
+        // start every component from its lowest degree actor
+        vector<int> byDegree(result);
+        stable_sort(byDegree.begin(), byDegree.end(), [this](int lhs, int rhs){
+            return edgeSet[lhs].size() < edgeSet[rhs].size();
+        });
+
+        vector<bool> placed(size, false); // actor already has a position
+        vector<int> neighbors;            // unplaced neighbors of an actor
+        int head = 0;                     // next actor to expand
+        int tail = 0;                     // next free position
+
+        for (int start : byDegree){
+            if (placed[start])
+                continue;
+            placed[start] = true;
+            result[tail++] = start;
+
+            // Cuthill-McKee: breadth first, lighter neighbors first
+            while (head < tail){
+                int curr = result[head++];
+                neighbors.clear();
+                for (ActorEdge& edge : edgeSet[curr]){
+                    if (!placed[edge.actor]){
+                        placed[edge.actor] = true;
+                        neighbors.push_back(edge.actor);
+                    }
+                }
+                stable_sort(neighbors.begin(), neighbors.end(),
+                                                    [this](int lhs, int rhs){
+                    return edgeSet[lhs].size() < edgeSet[rhs].size();
+                });
+                for (int neighbor : neighbors)
+                    result[tail++] = neighbor;
+            }
+        }
+        reverse(result.begin(), result.end());
+    }
 
+    return result;
+}
+
+/**
+ * Renumbers the actors so that actors which are traversed together sit next
+ * to each other in memory. Every edge is relabeled and the order of each
+ * edgeSet is kept, so traversals find the same paths as before.
+ * Parameters:
+ *      order: Ordering strategy to apply
+ *
+ */
+void ActorGraph::reorder(ActorOrder order){
+    if (order == ORDER_NONE || image)
+        return;
+
+    // the orderings read the edgeSets only
+    compact();
+
+    vector<int> oldIndex = computeOrder(order);
+    int size = oldIndex.size();
+
+    // newIndex is the inverse permutation of oldIndex
+    vector<int> newIndex(size);
+    for (int i = 0; i < size; i++)
+        newIndex[oldIndex[i]] = i;
+
+    // the names and edge lists are permuted, the search arrays only hold
+    // the state of the last search
+    vector<const char *> reorderedNames(size);
+    vector<vector<ActorEdge>> reorderedEdges(size);
+    vector<int> root(size);                  // component root, new indices
+    for (int i = 0; i < size; i++)
+        root[i] = newIndex[componentOf(oldIndex[i])];
+    for (int i = 0; i < size; i++){
+        reorderedNames[i] = names[oldIndex[i]];
+        reorderedEdges[i].swap(edgeSet[oldIndex[i]]);
+        for (ActorEdge& edge : reorderedEdges[i])
+            edge.actor = newIndex[edge.actor];
+    }
+    names.swap(reorderedNames);
+    edgeSet.swap(reorderedEdges);
+    for (auto& entry : nameIndex)
+        entry.second = newIndex[entry.second];
+    for (vector<int>& cast : casts)
+        for (int& actor : cast)
+            actor = newIndex[actor];
+    copy(root.begin(), root.end(), component);
+    initialize(state);
 }
 
 /**
@@ -356,8 +1541,10 @@ void ActorGraph::createGraph(unordered_map<Movie, vector<int>>& map,
  * Return: True or false if two actors are connected or not
  */  
 bool ActorGraph::testConnectivity(int fromActor, int toActor){
+	if (componentOf(fromActor) != componentOf(toActor))
+		return false;
 	BFSTraversal(fromActor, toActor);
-	return (actorSet[toActor]->prev != -1);
+	return (state.prev[toActor] != -1);
 
 }
 
@@ -4,7 +4,7 @@
  * Date:    November 13, 2016
  * 
  * Defines classes for ActorNodeComp, MovieComp, and ActorGraph. The first two
- * classes are used as functional classes to compare ActorNode and Movie 
+ * classes are used as functional classes to compare actors and Movie 
  * objects respectively. The ActorGraph class defines the member methods to 
  * update and traverse the graph. 
  *
@@ -13,16 +13,117 @@
 #ifndef ACTORGRAPH_H
 #define ACTORGRAPH_H
 
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
-#include "ActorNode.h"
+#include "Adjacency.h"
+#include "Arena.hpp"
+#include "Movie.h"
+#include "OutputWriter.h"
 
 using namespace std;
 
+/**
+ * Vertex orderings that ActorGraph::reorder can apply once the graph is built.
+ *      ORDER_NONE:   keep the file order of the cast list
+ *      ORDER_DEGREE: actors sorted by number of co-star edges, hubs first
+ *      ORDER_RCM:    reverse Cuthill-McKee, neighbors end up close in memory
+ */
+enum ActorOrder { ORDER_NONE, ORDER_DEGREE, ORDER_RCM };
+
+class GraphImage;
+class Landmarks;
+
+/**
+ * Edge from an actor to a co-star. The movie is an index into the movie
+ * table of the graph; its year is kept in the edge since every traversal
+ * reads it.
+ */
+struct ActorEdge{
+    int actor;      // index of the co-star
+    int movie;      // index of the movie in the movie table
+    int year;       // year of the movie
+};
+
+/**
+ * Edges of one actor from movies released up to a year, for use in a range
+ * based for loop. The frozen edgeSet of the actor and the edges added by
+ * deltas since the last compaction are both sorted by year and are visited
+ * merged by year, the edgeSet first within a year. That is the order the
+ * compaction merges them into, so a search visits the same edges in the
+ * same order before and after a compaction. Each list is left at its
+ * first later movie.
+ */
+class EdgeRange {
+	public:
+		class iterator {
+			const ActorEdge * curr;      // current edge, NULL at the end
+			const ActorEdge * base;      // next edge of the edgeSet
+			const ActorEdge * baseEnd;   // end of the edgeSet
+			const ActorEdge * delta;     // next edge of the deltaSet
+			const ActorEdge * deltaEnd;  // end of the deltaSet
+			int maxYear;            // latest year visited
+
+            /**
+             * Points curr at the earlier of the next edges of the lists
+             */
+			void settle(){
+				bool fromBase = base != baseEnd && base->year <= maxYear;
+				bool fromDelta = delta != deltaEnd && delta->year <= maxYear;
+				if (fromBase && (!fromDelta || base->year <= delta->year))
+					curr = base++;
+				else if (fromDelta)
+					curr = delta++;
+				else
+					curr = NULL;
+			}
+
+		public:
+			iterator() : curr(NULL), base(NULL), baseEnd(NULL), delta(NULL),
+			                                      deltaEnd(NULL), maxYear(0) {}
+
+			iterator(const ActorEdge * baseBegin, const ActorEdge * baseLast,
+			         const ActorEdge * deltaBegin, const ActorEdge * deltaLast,
+			         int year) : curr(NULL), base(baseBegin), baseEnd(baseLast),
+			         delta(deltaBegin), deltaEnd(deltaLast), maxYear(year) {
+				settle();
+			}
+
+			const ActorEdge& operator*() const { return *curr; }
+
+			iterator& operator++(){
+				settle();
+				return *this;
+			}
+
+			bool operator!=(const iterator& other) const {
+				return curr != other.curr;
+			}
+	};
+
+		EdgeRange(const vector<ActorEdge>& base, const vector<ActorEdge>& delta,
+		          int maxYear) : first(base.data(), base.data() + base.size(),
+		          delta.data(), delta.data() + delta.size(), maxYear) {}
+
+		EdgeRange(const ActorEdge * begin, const ActorEdge * end,
+		          int maxYear) : first(begin, end, NULL, NULL, maxYear) {}
+
+		iterator begin() const { return first; }
+		iterator end() const { return iterator(); }
+
+	private:
+		iterator first;     // first edge of the range
+};
+
 /** A 'function class' for use as the Compare class in a
  *  priority_queue<pair <int, int>>.
- *  First integer: index of the ActorNode
+ *  First integer: index of the actor
  *  Second integer: path cost
  */
 class ActorNodeComp {
@@ -66,22 +167,138 @@ class MovieComp {
 		}
 };
 
+// actors a search with a time limit expands between two reads of the clock
+#define BUDGET_CLOCK_INTERVAL 256
+
+/**
+ * Per-search fields of every actor. A graph keeps one for the searches run
+ * through its own methods; a thread searching a graph it shares with other
+ * threads brings its own, so the graph itself is only read.
+ *
+ * The limits bound every search run on the state. A search that runs out
+ * stops where it is: the actors it already made final keep their paths,
+ * the rest are left unreached and exceeded is set.
+ */
+struct SearchState{
+    vector<int> dist;       // distance from the source
+    vector<int> prev;       // previous actor on the path
+    vector<char> done;      // settled by Dijkstra or A*
+    vector<int> wanted;     // stamp if a target of the current search
+    int stamp;              // stamp of the current search
+    long maxExpansions;     // actors a search may expand, 0 for no limit
+    chrono::steady_clock::duration timeLimit; // time a search may take,
+                                              // zero for no limit
+    chrono::steady_clock::time_point deadline; // end of the current search
+    long expanded;          // actors the current search expanded
+    long checkAt;           // expansions at which the limits are checked
+    bool exceeded;          // current search stopped on a limit
+
+    SearchState() : stamp(0), maxExpansions(0), timeLimit(0), expanded(0),
+                    checkAt(LONG_MAX), exceeded(false) {}
+
+    /**
+     * Starts the limits of a new search
+     */
+    void startBudget();
+
+    /**
+     * Counts an actor the search expands against the limits. The clock is
+     * read every BUDGET_CLOCK_INTERVAL expansions only.
+     *
+     * Return: true if the search has to stop
+     */
+    bool expand(){
+        return ++expanded >= checkAt && overBudget();
+    }
+
+    /**
+     * Checks the limits and sets exceeded once one of them is hit
+     *
+     * Return: true if the search has to stop
+     */
+    bool overBudget();
+};
+
 /**
  * A class that defines all the member methods related to the graph of 
- * ActorNodes.
+ * actors. Actors are stored as parallel arrays indexed by actor: names and
+ * components live in an arena, so loading does not allocate a node per
+ * actor and the destructor frees a handful of blocks. The fields a search
+ * writes are kept apart in a SearchState.
  *
  */ 
 class ActorGraph {
-	friend class UnionFind;  // allows access to UnionFind private variables
 	private:
 		/**
-		 * Initializes the member fields of nodes to correct default value
+		 * Initializes the fields of a search to correct default values
+		 * Parameters:
+		 *      state: Fields to initialize, sized to the graph if needed
 		 */ 
-		void initialize();
+		void initialize(SearchState& state) const;
+
+		/**
+		 * Allocates the per-search arrays once every actor is known
+		 */
+		void allocateState();
+
+		/**
+		 * Marks the actors a search has to reach before it may stop
+		 * Parameters:
+		 *      state: Fields of the search
+		 *      fromActor: index of Actor the search starts from
+		 *      targets: indices of Actors to reach
+		 *
+		 * Return: Number of distinct targets other than fromActor
+		 */
+		int markTargets(SearchState& state, int fromActor,
+		                                    const vector<int>& targets) const;
+
+		/**
+		 * Root of an actor's component, halving the path on the way
+		 * Parameters:
+		 *      actor: index of Actor
+		 *
+		 * Return: Index of the actor representing the component
+		 */
+		int findComponent(int actor);
+
+		/**
+		 * Joins the components of two actors
+		 * Parameters:
+		 *      left: index of an Actor
+		 *      right: index of an Actor sharing a movie with left
+		 *
+		 */
+		void joinComponents(int left, int right);
+
+		Arena arena;                    // owns the names and components
+		vector<const char *> names;     // name of each actor
+		SearchState state;              // fields of the graph's own searches
+		int * component;                // up-tree of the connected components
+		unordered_map<string, int> nameIndex; // actor name to index
+		vector<vector<ActorEdge>> edgeSet; // edges leaving each actor
+		vector<vector<ActorEdge>> deltaSet; // edges added since compaction
+		vector<Movie> movies;           // movie table indexed by ActorEdge
+		unordered_map<Movie, int> movieIndex; // movie to its table index
+		vector<vector<int>> casts;      // actors of each movie in the table
+		long edgeCount;      // number of directed edges over all edgeSets
+
+		GraphImage * image;             // shared image the graph reads, if any
+		const ActorEdge * imageEdges;   // edges of every actor in the image
+		const int64_t * imageOffsets;   // start of each actor's edges there
+
+		thread compactor;               // merges deltaSet in the background
+		atomic<bool> compactionDone;    // compactor has filled compacted
+		vector<pair<int, vector<ActorEdge>>> compacted; // merged edgeSets
+
+		/**
+		 * Merges the deltaSet of every actor that has one into a copy of
+		 * its edgeSet, without touching either
+		 */
+		void mergeDelta();
 
 
 	public:
-		vector<ActorNode *> actorSet;//underlying data structure for ActorGraph
 		
         /**
 		 * default constructor for ActorGraph object
@@ -93,25 +310,134 @@ class ActorGraph {
          */ 
 		~ActorGraph(void);
 
+		/**
+		 * Number of actors
+		 *
+		 * Return: Number of actors loaded
+		 */
+		int size() const { return names.size(); }
+
+		/**
+		 * Name of an actor
+		 * Parameters:
+		 *      actor: index of Actor
+		 *
+		 * Return: Name of the actor, owned by the graph
+		 */
+		const char * nameOf(int actor) const { return names[actor]; }
+
 		/** 
-		 * Locates ActorNode inside the graph given the name of the actor
+		 * Locates an actor inside the graph given the name of the actor
 		 * Parameters:
 		 *      name: Name of actor
 		 *
-		 * Return: Index of actor     
+		 * Return: Index of actor, -1 if there is no such actor
 		 */ 
-		int locateActor ( string name );
+		int locateActor ( string name ) const;
 
 		/** 
 		 * Load the graph from a tab-delimited file of actor->movie 
-		 * relationships.
+		 * relationships. Chunks of the file are parsed on threads; the
+		 * actors are numbered in file order all the same.
 		 * Parameters:
 		 *      in_filename - input filename
+		 *      map - set to the indices of the actors of every movie
+		 *      threads - threads to parse with, 0 for one per core
 		 *
 		 * Return: true if file was loaded sucessfully, false otherwise
 		 */
 		bool loadFromFile(const char* in_filename, unordered_map<Movie,
-                                                            vector<int>>& map);
+		                  vector<int>>& map, int threads = 0);
+
+		/** 
+		 * Adds the actors and movies of a delta cast file to a built graph.
+		 * The new edges go to the deltaSet of each actor and are visible to
+		 * the next search; the frozen edgeSets are not touched.
+		 * Parameters:
+		 *      in_filename - delta file, same format as loadFromFile
+		 *
+		 * Return: Number of movies added or extended, -1 if the file could
+		 *         not be read
+		 */
+		int loadDelta(const char* in_filename);
+
+		/**
+		 * Merges the deltaSets into the edgeSets. In the background the
+		 * merged lists are built on a thread while searches keep reading
+		 * the old ones, and finishCompaction swaps them in.
+		 * Parameters:
+		 *      background: Return at once and merge on a thread
+		 *
+		 */
+		void compact(bool background = false);
+
+		/**
+		 * Swaps in the edge lists merged by a background compaction.
+		 * Searches see the same edges before and after the swap.
+		 * Parameters:
+		 *      wait: Wait for the thread if it is still merging
+		 *
+		 * Return: true if no compaction is left running, false otherwise
+		 */
+		bool finishCompaction(bool wait = true);
+
+		/**
+		 * Deep copy of the graph, for building its next version off to
+		 * the side while searches keep reading this one. The copy has its
+		 * own arena and search fields and no compaction running.
+		 *
+		 * Return: New graph, owned by the caller
+		 */
+		ActorGraph * clone() const;
+
+        /**
+         * Merges the deltas and writes the graph to a shared image that
+         * other processes can attach to
+         * Parameters:
+         *      name: Segment like "/pa4graph" for POSIX shared memory,
+         *            any other name is a file
+         *
+         * Return: true if the image was written, false otherwise
+         */
+		bool saveImage(const char * name);
+
+        /**
+         * Maps a shared image written by saveImage instead of loading a
+         * cast file. The edges, names and components are read in place
+         * from memory every attached process shares, and the graph can no
+         * longer be changed.
+         * Parameters:
+         *      name: Segment or file the image was written to
+         *
+         * Return: true if the image was attached, false if the graph is
+         *         not empty or the image is missing or invalid
+         */
+		bool attachImage(const char * name);
+
+        /**
+         * Number of movies in the movie table
+         *
+         * Return: Number of movies
+         */
+		int movieCount() const;
+
+        /**
+         * Title of a movie in the movie table
+         * Parameters:
+         *      movie: index of the Movie
+         *
+         * Return: Title of the movie
+         */
+		const char * titleOf(int movie) const;
+
+        /**
+         * Year of a movie in the movie table
+         * Parameters:
+         *      movie: index of the Movie
+         *
+         * Return: Release year of the movie
+         */
+		int yearOf(int movie) const;
         
         /**
          * Checks if two actors are connected
@@ -124,7 +450,17 @@ class ActorGraph {
 		bool testConnectivity(int fromActor, int toActor);
 
         /**
-         * Creates entire graph at once for pathfinder
+         * Connected component of an actor over every edge added so far
+         * Parameters:
+         *      actor: index of Actor
+         *
+         * Return: Index of the actor representing the component
+         */
+		int componentOf(int actor) const;
+
+        /**
+         * Creates entire graph at once for pathfinder. Every edgeSet ends up
+         * sorted by movie year, oldest first.
          * Parameters:
          *      map: Map with pairs of Movie and vector of Actor indices
          *
@@ -132,7 +468,8 @@ class ActorGraph {
 		void createGraph(unordered_map <Movie, vector<int>>& map);
 
         /**
-         * Creates graph year by year for actorconnections
+         * Creates graph year by year for actorconnections. Movies have to
+         * be added in order of year to keep every edgeSet sorted by year.
          * Parameters:
          *      map: Map with pairs of Movie and vector of Actor indices
          *      movie: Movie reference to connect actors who acted in it
@@ -140,17 +477,83 @@ class ActorGraph {
          */       
 		void createGraph(unordered_map <Movie, vector<int>>& map,
                                              const Movie * const&  movie);
+
+        /**
+         * Renumbers the actors so that actors which are traversed together
+         * sit next to each other in memory. Every edge is relabeled and
+         * the order of each edgeSet is kept, so traversals find the same
+         * paths as before. Indices obtained before the call are invalid.
+         * Parameters:
+         *      order: Ordering strategy to apply
+         *
+         */
+		void reorder(ActorOrder order);
+
+        /**
+         * Computes the permutation used by reorder without applying it
+         * Parameters:
+         *      order: Ordering strategy to compute
+         *
+         * Return: Vector where entry i holds the old index of the actor
+         *         that is placed at index i
+         */
+		vector<int> computeOrder(ActorOrder order);
 		
 		/** 
 		 * Creates the edges and fills the member fields of each node inside 
 		 * the map such that nodes are connected with the shortest unweighted
-		 *  distances
+		 *  distances. Direction optimizing: switches between top-down and
+		 *  bottom-up steps depending on the size of the frontier.
 		 *  Parameters:
 		 *      fromActor: index of Actor to start BFS traversal from
 		 *      toActor: index of Actor connected to fromActor
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */ 
+		void BFSTraversal(int fromActor, int toActor, int maxYear = INT_MAX);
+
+		/** 
+		 * Direction optimizing BFS that stops once every target has been
+		 * reached. Each target gets the path a search for it alone finds.
+		 *  Parameters:
+		 *      fromActor: index of Actor to start BFS traversal from
+		 *      targets: indices of Actors to reach, empty for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */ 
+		void BFSTraversal(int fromActor, const vector<int>& targets,
+		                                               int maxYear = INT_MAX);
+
+		/** 
+		 * Multi target BFS writing to the given search fields only, so
+		 * threads with their own state may run it on one graph at once
+		 *  Parameters:
+		 *      state: Fields of the search
+		 *      fromActor: index of Actor to start BFS traversal from
+		 *      targets: indices of Actors to reach, empty for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */ 
+		void BFSTraversal(SearchState& state, int fromActor,
+		             const vector<int>& targets, int maxYear = INT_MAX) const;
+
+		/** 
+		 * Runs a batch of top-down BFS searches interleaved on one thread.
+		 * Each search steps in turn, prefetching the memory its next step
+		 * reads, so the cache misses of one search overlap with the work
+		 * of the others. Every search finds the same paths a FIFO search
+		 * for it alone does.
+		 *  Parameters:
+		 *      states: Fields of each search, at least one per root
+		 *      roots: index of the Actor each search starts from
+		 *      targets: indices of Actors each search has to reach, empty
+		 *               for every actor
+		 *      maxYear: Only movies released up to this year link actors
 		 *
 		 */ 
-		void BFSTraversal(int fromActor, int toActor);
+		void BFSBatch(vector<SearchState>& states, const vector<int>& roots,
+		              const vector<vector<int>>& targets,
+		              int maxYear = INT_MAX) const;
 
 		/** 
 		 * Creates the edges and fills the member fields of each node inside 
@@ -158,22 +561,192 @@ class ActorGraph {
 		 * distances
 		 * Parameters:
 		 *      fromActor: index of Actor to start Dijkstra traversal from
+		 *      toActor: index of Actor connected to fromActor, or -1 to
+		 *               compute the distance of every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */
+		void Dijkstra(int fromActor, int toActor, int maxYear = INT_MAX);
+
+		/** 
+		 * Dijkstra that stops once every target is settled. Each target
+		 * gets the path a search for it alone finds.
+		 * Parameters:
+		 *      fromActor: index of Actor to start Dijkstra traversal from
+		 *      targets: indices of Actors to settle, empty for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */
+		void Dijkstra(int fromActor, const vector<int>& targets,
+		                                               int maxYear = INT_MAX);
+
+		/** 
+		 * Goal directed version of Dijkstra. The queue is ordered by the
+		 * distance plus the landmark lower bound on the distance left to
+		 * toActor, which settles far fewer actors while finding a path of
+		 * the same weighted length.
+		 * Parameters:
+		 *      fromActor: index of Actor to start A* search from
 		 *      toActor: index of Actor connected to fromActor
+		 *      landmarks: Landmark distances built over this graph. Bounds
+		 *                 from the full graph stay valid under maxYear.
+		 *      maxYear: Only movies released up to this year link actors
+		 *
+		 */
+		void AStar(int fromActor, int toActor, const Landmarks& landmarks,
+		                                           int maxYear = INT_MAX);
+
+		/** 
+		 * Best first search shared by every cost model, defined in
+		 * SearchEngine.hpp together with the policies it is built from.
+		 * Parameters:
+		 *      fromActor: index of Actor to start from
+		 *      toActor: index of Actor to stop at, or -1 for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *      weight: Weight policy, cost of an ActorEdge
+		 *      heuristic: Heuristic policy, lower bound on the cost left
+		 *
+		 */
+		template<typename Queue, typename Weight, typename Heuristic>
+		void search(int fromActor, int toActor, int maxYear,
+		            const Weight& weight, const Heuristic& heuristic);
+
+		/** 
+		 * Best first search that stops once every target is final
+		 * Parameters:
+		 *      fromActor: index of Actor to start from
+		 *      targets: indices of Actors to reach, empty for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *      weight: Weight policy, cost of an ActorEdge
+		 *      heuristic: Heuristic policy, lower bound on the cost left
+		 *
+		 */
+		template<typename Queue, typename Weight, typename Heuristic>
+		void search(int fromActor, const vector<int>& targets, int maxYear,
+		            const Weight& weight, const Heuristic& heuristic);
+
+		/** 
+		 * Best first search writing to the given search fields only
+		 * Parameters:
+		 *      state: Fields of the search
+		 *      fromActor: index of Actor to start from
+		 *      targets: indices of Actors to reach, empty for every actor
+		 *      maxYear: Only movies released up to this year link actors
+		 *      weight: Weight policy, cost of an ActorEdge
+		 *      heuristic: Heuristic policy, lower bound on the cost left
+		 *
+		 */
+		template<typename Queue, typename Weight, typename Heuristic>
+		void search(SearchState& state, int fromActor,
+		            const vector<int>& targets, int maxYear,
+		            const Weight& weight, const Heuristic& heuristic) const;
+
+		/**
+		 * Distance of an actor found by the last traversal
+		 * Parameters:
+		 *      actor: index of Actor
+		 *
+		 * Return: Distance from the source, INT_MAX if it was not reached
+		 */
+		int distanceTo(int actor);
+
+		/**
+		 * Number of edges leaving an actor, one per co-star per movie
+		 * Parameters:
+		 *      actor: index of Actor
+		 *
+		 * Return: Size of the actor's edgeSet and deltaSet
+		 */
+		int degreeOf(int actor) const;
+
+		/**
+		 * Edges of an actor from movies released up to a year, the
+		 * edgeSet and deltaSet merged by year
+		 * Parameters:
+		 *      actor: index of Actor
+		 *      maxYear: Only movies released up to this year are visited
 		 *
+		 * Return: Range of the actor's edges
 		 */
-		void Dijkstra(int fromActor, int toActor);
+		EdgeRange edgesOf(int actor, int maxYear = INT_MAX) const {
+			if (image)
+				return EdgeRange(imageEdges + imageOffsets[actor],
+				                 imageEdges + imageOffsets[actor + 1], maxYear);
+			return EdgeRange(edgeSet[actor], deltaSet[actor], maxYear);
+		}
+
+        /**
+         * Fills a compressed copy of the graph for read only traversals
+         * Parameters:
+         *      adjacency: Adjacency to fill
+         *      weighted: Also store the lowest 2016 - year weight of the
+         *                movies two co-stars share
+         *
+         */
+		void buildAdjacency(Adjacency& adjacency, bool weighted);
 
 		/**
 		 * Prints the shortest distance and the movies connecting two actors.
 		 * Parameters:
 		 *      fromActor: index of Actor to print connection from
 		 *      toActor: index of Actor connected to fromActor
-		 *      outfile: Stream to output results
+		 *      outfile: Buffer to format the results into
+		 *      use_weighted_edges: Use dijkstra or BFS 
+		 *      maxYear: Only movies released up to this year link actors
+		 *      rootedAtTo: The last search started from toActor instead
+		 *
+		 */
+		void printConnections(int fromActor, int toActor, OutputBuffer& outfile,
+                           bool use_weighted_edges, int maxYear = INT_MAX,
+                                                      bool rootedAtTo = false);
+
+		/**
+		 * Prints the connection found by a search run on the given fields,
+		 * or that the search ran out of its limits before settling it
+		 * Parameters:
+		 *      state: Fields of the search that ran
+		 *      fromActor: index of Actor to print connection from
+		 *      toActor: index of Actor connected to fromActor
+		 *      outfile: Buffer to format the results into
 		 *      use_weighted_edges: Use dijkstra or BFS 
+		 *      maxYear: Only movies released up to this year link actors
+		 *      rootedAtTo: The search started from toActor instead
+		 *
+		 */
+		void printConnections(const SearchState& state, int fromActor,
+		                      int toActor, OutputBuffer& outfile,
+		                      bool use_weighted_edges, int maxYear = INT_MAX,
+		                      bool rootedAtTo = false) const;
+
+		/**
+		 * Whether a search settled the connection of two actors: the path
+		 * found is final or the actors are not connected. Only a search
+		 * stopped by the limits of its state leaves a connection unsettled.
+		 * Parameters:
+		 *      state: Fields of the search that ran
+		 *      fromActor: index of Actor the connection starts from
+		 *      toActor: index of Actor the connection ends at
+		 *      use_weighted_edges: The search was Dijkstra or A*
+		 *      rootedAtTo: The search started from toActor instead
+		 *
+		 * Return: true if printConnections prints a path or no connection
+		 */
+		bool settled(const SearchState& state, int fromActor, int toActor,
+		             bool use_weighted_edges, bool rootedAtTo = false) const;
+
+		/**
+		 * Prints a path of actors and the movies linking each consecutive
+		 * pair in the format of printConnections, or the first pair that
+		 * shares no movie.
+		 * Parameters:
+		 *      path: indices of the Actors on the path, in order
+		 *      outfile: Buffer to format the results into
+		 *      use_weighted_edges: Link actors with their newest shared movie
+		 *      maxYear: Only movies released up to this year link actors
 		 *
 		 */
-		void printConnections(int fromActor, int toActor, ofstream & outfile,
-                                                     bool use_weighted_edges);
+		void printPath(const vector<int>& path, OutputBuffer& outfile,
+		               bool use_weighted_edges, int maxYear = INT_MAX) const;
 };
 
 #endif // ACTORGRAPH_H
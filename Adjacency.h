@@ -0,0 +1,45 @@
+/**
+ * Name: Haiyu Huang, Kyle Chang
+ * Date: November 29, 2016
+ * CSE 100 Fall 2016
+ * PA4: Graph Theory
+ * File: Adjacency.h
+ * Description: Struct definition for the compressed, read only adjacency
+ *              used by the whole-graph analytics.
+ */
+
+
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Compressed adjacency of the actor graph. The co-stars of actor i are
+ * targets[offsets[i]] up to targets[offsets[i + 1] - 1], each listed once no
+ * matter how many movies the two actors share. The struct is never written
+ * after it is built, so any number of threads can traverse it at once.
+ */
+struct Adjacency{
+    vector<int> offsets;   // start of each actor's co-stars, size n + 1
+    vector<int> targets;   // co-star indices
+    vector<int> weights;   // lowest edge weight to each co-star, if built
+
+    /**
+     * Number of actors
+     */
+    int size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    /**
+     * Number of distinct co-stars of an actor
+     */
+    int degree(int actor) const {
+        return offsets[actor + 1] - offsets[actor];
+    }
+};
+
+#endif // ADJACENCY_H
@@ -0,0 +1,129 @@
+/*
+ * Arena.hpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 4, 2016
+ *
+ * This file declares and defines a bump allocator for the per-node arrays
+ * and the actor names of the graphs, so a graph owns a few large blocks
+ * instead of one heap object per node and frees them all at once.
+ */
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Class to define member variables and methods of a bump allocator. Memory
+ * is carved out of blocks of BLOCK_SIZE bytes in order; nothing is freed on
+ * its own, release frees every block. Only types without a destructor can
+ * be allocated, since none is ever run.
+ *
+ */
+class Arena{
+
+	static const size_t BLOCK_SIZE = 1 << 20;  // bytes of a regular block
+
+	vector<char *> blocks;  // every block allocated so far
+	char * curr;            // next free byte of the current block
+	size_t left;            // free bytes left in the current block
+
+    /**
+     * Raw memory from the arena
+     * Parameters:
+     *      bytes: Number of bytes
+     *      align: Alignment of the memory, a power of two
+     *
+     * Return: Pointer to the memory
+     */
+	void * raw(size_t bytes, size_t align){
+		size_t pad = (align - ((size_t)curr & (align - 1))) & (align - 1);
+		if (curr && pad + bytes <= left){
+			char * memory = curr + pad;
+			curr = memory + bytes;
+			left -= pad + bytes;
+			return memory;
+		}
+
+		// large requests get a block of their own, the current one stays
+		if (bytes > BLOCK_SIZE / 4){
+			char * block = (char *)malloc(bytes);
+			if (!block)
+				throw bad_alloc();
+			blocks.push_back(block);
+			return block;
+		}
+		char * block = (char *)malloc(BLOCK_SIZE);
+		if (!block)
+			throw bad_alloc();
+		blocks.push_back(block);
+		curr = block + bytes;
+		left = BLOCK_SIZE - bytes;
+		return block;
+	}
+
+public:
+    /**
+     * Constructor for an empty Arena
+     */
+	Arena() : curr(NULL), left(0) {}
+
+    /**
+     * Destructor, frees every block
+     */
+	~Arena(){
+		release();
+	}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Array of count objects, value initialized
+     * Parameters:
+     *      count: Number of objects
+     *
+     * Return: Pointer to the first object
+     */
+	template<typename T>
+	T * allocate(size_t count){
+		static_assert(is_trivially_destructible<T>::value,
+		              "arena objects are never destroyed");
+		T * array = (T *)raw(count * sizeof(T), alignof(T));
+		for (size_t i = 0; i < count; i++)
+			new (array + i) T();
+		return array;
+	}
+
+    /**
+     * Copy of a string, terminated by a null character
+     * Parameters:
+     *      text: String to copy
+     *
+     * Return: Pointer to the copy
+     */
+	const char * copy(const string& text){
+		char * memory = (char *)raw(text.size() + 1, 1);
+		memcpy(memory, text.c_str(), text.size() + 1);
+		return memory;
+	}
+
+    /**
+     * Frees every block. Memory handed out before the call is invalid.
+     */
+	void release(){
+		for (char * block : blocks)
+			free(block);
+		blocks.clear();
+		curr = NULL;
+		left = 0;
+	}
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,57 @@
+/*
+ * Barrier.hpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 1, 2016
+ *
+ * This file declares and defines a reusable barrier, so a fixed set of
+ * threads can step through phases together without being started and
+ * joined for every phase.
+ */
+#ifndef BARRIER_HPP
+#define BARRIER_HPP
+
+#include <condition_variable>
+#include <mutex>
+
+using namespace std;
+
+/**
+ * Class to define member variables and methods of a barrier for a fixed
+ * number of threads. Everything a thread wrote before wait is seen by all
+ * the threads after it, so phase data needs no other synchronization.
+ *
+ */
+class Barrier{
+	mutex lock;                 // guards the fields below
+	condition_variable wake;    // signaled when a phase ends
+	int count;                  // threads that meet at the barrier
+	int waiting;                // threads arrived in the current phase
+	unsigned long generation;   // phases ended so far
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      threads: Number of threads that meet at the barrier
+         */
+		Barrier(int threads) : count(threads), waiting(0), generation(0) {}
+
+        /**
+         * Blocks until every thread has called wait for this phase
+         *
+         */
+		void wait(){
+			unique_lock<mutex> hold(lock);
+			unsigned long arrived = generation;
+			if (++waiting == count){
+				waiting = 0;
+				generation++;
+				wake.notify_all();
+				return;
+			}
+			while (generation == arrived)
+				wake.wait(hold);
+		}
+};
+
+#endif // BARRIER_HPP
@@ -0,0 +1,200 @@
+/*
+ * Betweenness.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 10, 2016
+ *
+ * Implements the betweenness centrality declared in Betweenness.h.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Betweenness.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * Parameters:
+ *      adjacency: Graph to analyze, must outlive the object
+ *      threads: Number of worker threads, 0 for one per core
+ */
+BetweennessCentrality::BetweennessCentrality(const Adjacency& adjacency,
+                                             int threads) : graph(adjacency) {
+	numThreads = resolveThreads(threads);
+}
+
+/**
+ * Adds the dependencies of one source on every actor to the scores of a
+ * thread. The BFS counts the shortest paths to every actor; the pass back
+ * over the actors in reverse BFS order hands each actor's dependency to
+ * the actors one hop closer, in proportion to the paths through them, so
+ * no predecessor lists are kept.
+ * Parameters:
+ *      source: index of Actor to start from
+ *      scratch: Scratch space of the thread, dist -1 for every actor not
+ *               in order
+ *
+ */
+void BetweennessCentrality::accumulate(int source, Scratch& scratch){
+	vector<int>& dist = scratch.dist;
+	vector<double>& paths = scratch.paths;
+	vector<double>& delta = scratch.delta;
+	vector<int>& order = scratch.order;
+
+	// undo the previous search
+	for (int actor : order){
+		dist[actor] = -1;
+		paths[actor] = 0;
+		delta[actor] = 0;
+	}
+	order.clear();
+
+	dist[source] = 0;
+	paths[source] = 1;
+	order.push_back(source);
+	for (size_t head = 0; head < order.size(); head++){
+		int curr = order[head];
+		int next = dist[curr] + 1;
+		for (int k = graph.offsets[curr]; k < graph.offsets[curr + 1]; k++){
+			int neighbor = graph.targets[k];
+			if (dist[neighbor] == -1){
+				dist[neighbor] = next;
+				order.push_back(neighbor);
+			}
+			if (dist[neighbor] == next)
+				paths[neighbor] += paths[curr];
+		}
+	}
+
+	for (size_t k = order.size() - 1; k > 0; k--){
+		int curr = order[k];
+		int prev = dist[curr] - 1;
+		double share = (1 + delta[curr]) / paths[curr];
+		for (int e = graph.offsets[curr]; e < graph.offsets[curr + 1]; e++){
+			int neighbor = graph.targets[e];
+			if (dist[neighbor] == prev)
+				delta[neighbor] += paths[neighbor] * share;
+		}
+		scratch.score[curr] += delta[curr];
+		if (!scratch.squares.empty())
+			scratch.squares[curr] += delta[curr] * delta[curr];
+	}
+}
+
+/**
+ * Sums the dependencies of the given sources over the threads
+ * Parameters:
+ *      sources: indices of the source actors
+ *      squares: Filled with the squared dependencies summed, if not NULL
+ *
+ * Return: Dependencies of every actor summed over the sources
+ */
+vector<double> BetweennessCentrality::run(const vector<int>& sources,
+                                          vector<double>* squares){
+	int size = graph.size();
+
+	// every thread keeps its own scratch space and scores
+	vector<Scratch> scratch(numThreads);
+	for (Scratch& local : scratch){
+		local.dist.assign(size, -1);
+		local.paths.assign(size, 0);
+		local.delta.assign(size, 0);
+		local.score.assign(size, 0);
+		if (squares)
+			local.squares.assign(size, 0);
+	}
+
+	parallelFor(numThreads, sources.size(), [&](int item, int t){
+		accumulate(sources[item], scratch[t]);
+	});
+
+	vector<double> total(size, 0);
+	if (squares)
+		squares->assign(size, 0);
+	for (Scratch& local : scratch){
+		for (int actor = 0; actor < size; actor++){
+			total[actor] += local.score[actor];
+			if (squares)
+				(*squares)[actor] += local.squares[actor];
+		}
+	}
+	return total;
+}
+
+/**
+ * Exact betweenness of every actor, one BFS per actor. Every unordered pair
+ * is reached from both ends, so the summed dependencies are halved.
+ *
+ * Return: Betweenness of actor i at position i
+ */
+vector<double> BetweennessCentrality::exact(){
+	int size = graph.size();
+	vector<int> sources(size);
+	for (int actor = 0; actor < size; actor++)
+		sources[actor] = actor;
+
+	vector<double> score = run(sources, NULL);
+	for (double& value : score)
+		value /= 2;
+	return score;
+}
+
+/**
+ * Betweenness of every actor estimated from random sources
+ * Parameters:
+ *      samples: Number of BFS sources
+ *      seed: Seed for picking the sources
+ *      stdError: Filled with the standard error of each estimate
+ *
+ * Return: Estimated betweenness of actor i at position i
+ */
+vector<double> BetweennessCentrality::sampled(int samples, unsigned seed,
+                                              vector<double>& stdError){
+	int size = graph.size();
+	stdError.assign(size, 0);
+	if (size == 0 || samples <= 0)
+		return vector<double>(size, 0);
+
+	mt19937 random(seed);
+	uniform_int_distribution<int> pick(0, size - 1);
+	vector<int> sources(samples);
+	for (int k = 0; k < samples; k++)
+		sources[k] = pick(random);
+
+	vector<double> squares;
+	vector<double> score = run(sources, &squares);
+
+	// a source stands for all the actors, and every pair is counted once
+	double scale = size / 2.0;
+	for (int actor = 0; actor < size; actor++){
+		double mean = score[actor] / samples;
+		if (samples > 1){
+			double variance = (squares[actor] - samples * mean * mean) /
+			                                                  (samples - 1);
+			stdError[actor] = scale * sqrt(max(variance, 0.0) / samples);
+		}
+		score[actor] = scale * mean;
+	}
+	return score;
+}
+
+/**
+ * Error every sampled estimate stays within at once, except with the given
+ * probability
+ * Parameters:
+ *      actors: Number of actors
+ *      samples: Number of BFS sources
+ *      failure: Probability allowed for any estimate to be off by more
+ *
+ * Return: Largest error of any estimate in betweenness
+ */
+double BetweennessCentrality::errorBound(int actors, int samples,
+                                         double failure){
+	if (actors < 3 || samples <= 0)
+		return 0;
+	double deviation = (actors - 2) *
+	                   sqrt(log(2.0 * actors / failure) / (2.0 * samples));
+	return actors / 2.0 * deviation;
+}
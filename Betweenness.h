@@ -0,0 +1,115 @@
+/*
+ * Betweenness.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 10, 2016
+ *
+ * Defines the BetweennessCentrality class, which finds the actors that
+ * bridge the co-star network: the betweenness of an actor is the number
+ * of shortest co-star chains between two other actors that pass through
+ * it, each chain counted as its share of all the shortest chains between
+ * the pair. Brandes' algorithm gets the dependencies of every actor on one
+ * source from a BFS and a pass back over it; sources are spread over
+ * threads that each add into their own scores, summed at the end.
+ */
+
+#ifndef BETWEENNESS_H
+#define BETWEENNESS_H
+
+#include <vector>
+#include <functional>
+#include "Adjacency.h"
+#include "ParallelFor.hpp"
+
+using namespace std;
+
+/**
+ * Betweenness centrality over an Adjacency, exact or from sampled sources
+ */
+class BetweennessCentrality {
+	private:
+		const Adjacency& graph;   // graph shared by all the threads
+		int numThreads;           // worker threads
+
+        /**
+         * Scratch space and running scores of one thread
+         */
+		struct Scratch{
+			vector<int> dist;       // hops from the source, -1 if unreached
+			vector<double> paths;   // shortest paths from the source
+			vector<double> delta;   // dependency of the source on an actor
+			vector<int> order;      // actors in the order the BFS reached
+			vector<double> score;   // dependencies summed over sources
+			vector<double> squares; // squared dependencies summed, if kept
+		};
+
+        /**
+         * Adds the dependencies of one source on every actor to the scores
+         * of a thread
+         * Parameters:
+         *      source: index of Actor to start from
+         *      scratch: Scratch space of the thread
+         *
+         */
+		void accumulate(int source, Scratch& scratch);
+
+        /**
+         * Sums the dependencies of the given sources over the threads
+         * Parameters:
+         *      sources: indices of the source actors
+         *      squares: Filled with the squared dependencies summed, if
+         *               not NULL
+         *
+         * Return: Dependencies of every actor summed over the sources
+         */
+		vector<double> run(const vector<int>& sources,
+		                   vector<double>* squares);
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      adjacency: Graph to analyze, must outlive the object
+         *      threads: Number of worker threads, 0 for one per core
+         */
+		BetweennessCentrality(const Adjacency& adjacency, int threads);
+
+        /**
+         * Exact betweenness of every actor, one BFS per actor
+         *
+         * Return: Betweenness of actor i at position i, over unordered
+         *         pairs of other actors
+         */
+		vector<double> exact();
+
+        /**
+         * Betweenness of every actor estimated from random sources, picked
+         * with replacement. Each source gives an unbiased estimate, the
+         * actors times its dependencies, and the estimate is their mean.
+         * Parameters:
+         *      samples: Number of BFS sources
+         *      seed: Seed for picking the sources
+         *      stdError: Filled with the standard error of each estimate,
+         *                from the spread of the samples
+         *
+         * Return: Estimated betweenness of actor i at position i
+         */
+		vector<double> sampled(int samples, unsigned seed,
+		                       vector<double>& stdError);
+
+        /**
+         * Error every sampled estimate stays within at once, except with
+         * the given probability. A dependency lies in [0, actors - 2], so
+         * Hoeffding's inequality with a union bound over the actors gives
+         * it whatever the graph looks like.
+         * Parameters:
+         *      actors: Number of actors
+         *      samples: Number of BFS sources
+         *      failure: Probability allowed for any estimate to be off by
+         *               more
+         *
+         * Return: Largest error of any estimate in betweenness
+         */
+		static double errorBound(int actors, int samples, double failure);
+};
+
+#endif // BETWEENNESS_H
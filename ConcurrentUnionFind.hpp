@@ -0,0 +1,174 @@
+/*
+ * ConcurrentUnionFind.hpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   November 30, 2016
+ *
+ * This file declares and defines a lock-free disjoint set, so the merges of
+ * one year of movies in actor connections can be applied by many threads
+ * at the same time.
+ */
+#ifndef CONCURRENTUNIONFIND_HPP
+#define CONCURRENTUNIONFIND_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+/**
+ * Class to define member variables and methods of a lock-free disjoint set.
+ * Each element is one 64 bit word holding its rank in the upper half and
+ * its parent in the lower half; a sentinel is its own parent. Roots are
+ * linked with compare-and-swap by (rank, index) order, and find halves the
+ * path it walks without allocating.
+ *
+ */
+class ConcurrentUnionFind{
+
+	atomic<uint64_t> * dataArray; // rank and parent of every element
+	int arrayLength;              // length of the dataArray
+
+    /**
+     * Packs a parent and a rank into one word
+     */
+	static uint64_t pack(int parent, uint32_t rank){
+		return ((uint64_t)rank << 32) | (uint32_t)parent;
+	}
+
+    /**
+     * Parent stored in a word
+     */
+	static int parentOf(uint64_t word){
+		return (int)(uint32_t)word;
+	}
+
+    /**
+     * Rank stored in a word
+     */
+	static uint32_t rankOf(uint64_t word){
+		return (uint32_t)(word >> 32);
+	}
+
+public:
+    /**
+     * Constructor for ConcurrentUnionFind object
+     * Parameters:
+     *      size: Number of elements, each starts in its own set
+     */
+	ConcurrentUnionFind(int size);
+
+	/**
+     * Destructor for ConcurrentUnionFind objects
+     */
+    ~ConcurrentUnionFind();
+
+    /**
+     * Finds the sentinel of the set an element is in. Safe to call while
+     * other threads merge.
+     * Parameters:
+     *      node: Index of the element
+     *
+     * Return: Sentinel of the set, which may change after later merges
+     */
+	int find(int node);
+
+    /**
+     * Merges the sets of two elements. Safe to call from many threads.
+     * Parameters:
+     *      left: Index of an element
+     *      right: Index of an element
+     */
+	void merge(int left, int right);
+
+};
+
+/**
+ * Constructor for ConcurrentUnionFind object
+ * Parameters:
+ *      size: Number of elements, each starts in its own set
+ */
+ConcurrentUnionFind::ConcurrentUnionFind(int size){
+	arrayLength = size;
+	dataArray = new atomic<uint64_t>[arrayLength];
+	for (int i = 0; i < arrayLength; i++)
+		dataArray[i].store(pack(i, 0), memory_order_relaxed);
+}
+
+/**
+ * Destructor for ConcurrentUnionFind object
+ */
+ConcurrentUnionFind::~ConcurrentUnionFind(){
+	delete[] dataArray;
+}
+
+/**
+ * Finds the sentinel of the set an element is in. Every element passed on
+ * the way is pointed at its grandparent (path halving); a failed swap only
+ * means another thread got there first.
+ * Parameters:
+ *      node: Index of the element
+ *
+ * Return: Sentinel of the set, which may change after later merges
+ */
+int ConcurrentUnionFind::find(int node){
+	int curr = node;
+	while (true){
+		uint64_t word = dataArray[curr].load();
+		int parent = parentOf(word);
+		if (parent == curr)
+			return curr;
+
+		int grandparent = parentOf(dataArray[parent].load());
+		if (grandparent != parent)
+			dataArray[curr].compare_exchange_weak(word,
+			                             pack(grandparent, rankOf(word)));
+		curr = grandparent;
+	}
+}
+
+/**
+ * Merges the sets of two elements. The sentinel lower in (rank, index)
+ * order is linked under the other one, which keeps the forest acyclic no
+ * matter how the threads interleave. If a sentinel stops being one before
+ * the link is made, the merge starts over.
+ * Parameters:
+ *      left: Index of an element
+ *      right: Index of an element
+ */
+void ConcurrentUnionFind::merge(int left, int right){
+	while (true){
+		int lower = find(left);
+		int upper = find(right);
+		if (lower == upper)
+			return;
+
+		uint64_t lowerWord = dataArray[lower].load();
+		uint64_t upperWord = dataArray[upper].load();
+		if (parentOf(lowerWord) != lower || parentOf(upperWord) != upper)
+			continue;
+
+		uint32_t lowerRank = rankOf(lowerWord);
+		uint32_t upperRank = rankOf(upperWord);
+		if (lowerRank > upperRank ||
+		                    (lowerRank == upperRank && lower > upper)){
+			swap(lower, upper);
+			swap(lowerWord, upperWord);
+			swap(lowerRank, upperRank);
+		}
+
+		// link the lower sentinel, only if it still is an untouched root
+		if (!dataArray[lower].compare_exchange_strong(lowerWord,
+		                                             pack(upper, lowerRank)))
+			continue;
+
+		// equal ranks grow the new sentinel, losing this race is harmless
+		if (lowerRank == upperRank)
+			dataArray[upper].compare_exchange_strong(upperWord,
+			                                    pack(upper, upperRank + 1));
+		return;
+	}
+}
+
+
+#endif // CONCURRENTUNIONFIND_HPP
@@ -0,0 +1,211 @@
+/*
+ * DeltaStepping.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 1, 2016
+ *
+ * Implements the parallel delta-stepping search declared in
+ * DeltaStepping.h.
+ */
+#include <algorithm>
+#include <climits>
+#include <thread>
+#include <vector>
+#include "DeltaStepping.h"
+
+using namespace std;
+
+// packed state of an actor not reached yet
+#define UNREACHED_STATE (((uint64_t)UINT32_MAX << 32) | UINT32_MAX)
+
+/**
+ * Distance stored in a packed state
+ */
+static inline uint32_t distanceOf(uint64_t word){
+	return (uint32_t)(word >> 32);
+}
+
+/**
+ * Constructor
+ * Parameters:
+ *      adjacency: Graph built with weights, must outlive the object
+ *      threads: Number of worker threads, 0 for one per core
+ *      width: Bucket width, 0 to derive it from the weight range and the
+ *             average degree
+ */
+DeltaStepping::DeltaStepping(const Adjacency& adjacency, int threads,
+                                          int width) : graph(adjacency) {
+	numThreads = resolveThreads(threads);
+	relaxed.resize(numThreads);
+	pool = NULL;
+	state = new atomic<uint64_t>[graph.size()];
+
+	// with weights spread over [0, W] and average degree d, a width of
+	// about W / d keeps few actors reinserted into the current bucket
+	delta = width;
+	if (delta <= 0){
+		int heaviest = 1;
+		for (int weight : graph.weights)
+			heaviest = max(heaviest, weight);
+		double degree = graph.size() ?
+		                (double)graph.targets.size() / graph.size() : 1;
+		delta = max(1, (int)(heaviest / max(degree, 1.0)));
+	}
+}
+
+/**
+ * Destructor
+ */
+DeltaStepping::~DeltaStepping(){
+	delete[] state;
+}
+
+/**
+ * Bucket width in use
+ *
+ * Return: delta
+ */
+int DeltaStepping::bucketWidth() const {
+	return delta;
+}
+
+/**
+ * Lowers the distance of an actor if the new one is shorter. Distance and
+ * previous actor are swapped in together, so the previous actor always
+ * belongs to the distance stored next to it.
+ * Parameters:
+ *      actor: index of the Actor reached
+ *      distance: Length of the new path
+ *      previous: Actor the new path comes from
+ *      thread: Thread that found the path
+ *
+ */
+void DeltaStepping::relax(int actor, uint32_t distance, int previous,
+                                                                int thread){
+	uint64_t word = state[actor].load(memory_order_relaxed);
+	uint64_t update = ((uint64_t)distance << 32) | (uint32_t)previous;
+	while (distance < distanceOf(word)){
+		if (state[actor].compare_exchange_weak(word, update)){
+			relaxed[thread].push_back(actor);
+			return;
+		}
+	}
+}
+
+/**
+ * Relaxes the edges of one thread's share of a list of actors: the light
+ * or the heavy edges of a contiguous slice of them
+ * Parameters:
+ *      actors: Actors whose edges are relaxed
+ *      light: Relax the edges of weight <= delta, or the others
+ *      thread: Thread the share belongs to
+ *
+ */
+void DeltaStepping::relaxShare(const vector<int>& actors, bool light,
+                                                                int thread){
+	int count = actors.size();
+	int begin = (long long)count * thread / numThreads;
+	int end = (long long)count * (thread + 1) / numThreads;
+	for (int i = begin; i < end; i++){
+		int curr = actors[i];
+		uint32_t distance = distanceOf(state[curr].load());
+		for (int k = graph.offsets[curr]; k < graph.offsets[curr + 1]; k++){
+			int weight = graph.weights[k];
+			if ((weight <= delta) == light)
+				relax(graph.targets[k], distance + weight, curr, thread);
+		}
+	}
+}
+
+/**
+ * Relaxes the light or the heavy edges of a list of actors in parallel and
+ * files the improved actors into their buckets
+ * Parameters:
+ *      actors: Actors whose edges are relaxed
+ *      light: Relax the edges of weight <= delta, or the others
+ *      buckets: Buckets to file improved actors into
+ *
+ */
+void DeltaStepping::relaxAll(const vector<int>& actors, bool light,
+                                             vector<vector<int>>& buckets){
+	pool->run([&](int t){
+		relaxShare(actors, light, t);
+	});
+
+	// the thread local buffers are merged on one thread
+	for (int t = 0; t < numThreads; t++){
+		for (int actor : relaxed[t]){
+			size_t bucket = distanceOf(state[actor].load()) / delta;
+			if (bucket >= buckets.size())
+				buckets.resize(bucket + 1);
+			buckets[bucket].push_back(actor);
+		}
+		relaxed[t].clear();
+	}
+}
+
+/**
+ * Shortest weighted distance from one actor to every actor
+ * Parameters:
+ *      source: index of the Actor to start from
+ *      dist: Filled with the distances, INT_MAX if not reached
+ *      prev: Filled with the previous actor on a shortest path, -1 for the
+ *            source and for actors not reached
+ *
+ */
+void DeltaStepping::run(int source, vector<int>& dist, vector<int>& prev){
+	int size = graph.size();
+	for (int actor = 0; actor < size; actor++)
+		state[actor].store(UNREACHED_STATE, memory_order_relaxed);
+	state[source].store((uint32_t)-1);   // distance 0, no previous actor
+
+	vector<vector<int>> buckets(1, vector<int>(1, source));
+	vector<int> frontier;        // actors of the current bucket to expand
+	vector<int> settled;         // actors settled in the current bucket
+	vector<int> expanded(size, -1);  // round an actor was last expanded in
+	vector<int> finished(size, -1);  // bucket an actor was settled in
+	int round = 0;
+
+	// the workers live for the whole search
+	WorkerPool workers(numThreads);
+	pool = &workers;
+
+	for (size_t current = 0; current < buckets.size(); current++){
+		settled.clear();
+
+		// light edges can refill the current bucket, repeat until empty
+		while (!buckets[current].empty()){
+			frontier.clear();
+			for (int actor : buckets[current]){
+				// stale entries moved to a lower bucket or are duplicates
+				if (distanceOf(state[actor].load()) / delta != current)
+					continue;
+				if (expanded[actor] == round)
+					continue;
+				expanded[actor] = round;
+				frontier.push_back(actor);
+				if (finished[actor] != (int)current){
+					finished[actor] = current;
+					settled.push_back(actor);
+				}
+			}
+			buckets[current].clear();
+			round++;
+			relaxAll(frontier, true, buckets);
+		}
+
+		// the bucket is final now, heavy edges only need one pass
+		relaxAll(settled, false, buckets);
+	}
+
+	pool = NULL;
+
+	dist.assign(size, INT_MAX);
+	prev.assign(size, -1);
+	for (int actor = 0; actor < size; actor++){
+		uint64_t word = state[actor].load();
+		if (distanceOf(word) == UINT32_MAX)
+			continue;
+		dist[actor] = distanceOf(word);
+		prev[actor] = (actor == source) ? -1 : (int)(uint32_t)word;
+	}
+}
@@ -0,0 +1,106 @@
+/*
+ * DeltaStepping.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 1, 2016
+ *
+ * Defines the DeltaStepping class, a parallel single source shortest path
+ * search over the weighted actor graph. Actors are kept in buckets of
+ * width delta by tentative distance; all actors of the current bucket are
+ * relaxed at once by the worker threads, light edges (weight <= delta)
+ * until the bucket stays empty and heavy edges once afterwards. The
+ * workers are started once per search and run every relaxation phase as
+ * a WorkerPool.
+ */
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Adjacency.h"
+#include "ParallelFor.hpp"
+
+using namespace std;
+
+/**
+ * Delta-stepping search over a weighted Adjacency
+ */
+class DeltaStepping {
+	private:
+		const Adjacency& graph;     // weighted graph shared by the threads
+		int numThreads;             // worker threads
+		int delta;                  // bucket width
+		atomic<uint64_t> * state;   // distance and previous actor, packed
+		vector<vector<int>> relaxed;// actors improved by each thread
+		WorkerPool * pool;          // workers of the running search
+
+        /**
+         * Relaxes the edges of one thread's share of a list of actors
+         * Parameters:
+         *      actors: Actors whose edges are relaxed
+         *      light: Relax the edges of weight <= delta, or the others
+         *      thread: Thread the share belongs to
+         *
+         */
+		void relaxShare(const vector<int>& actors, bool light, int thread);
+
+        /**
+         * Lowers the distance of an actor if the new one is shorter
+         * Parameters:
+         *      actor: index of the Actor reached
+         *      distance: Length of the new path
+         *      previous: Actor the new path comes from
+         *      thread: Thread that found the path
+         *
+         */
+		void relax(int actor, uint32_t distance, int previous, int thread);
+
+        /**
+         * Relaxes the light or the heavy edges of a list of actors in
+         * parallel and files the improved actors into their buckets
+         * Parameters:
+         *      actors: Actors whose edges are relaxed
+         *      light: Relax the edges of weight <= delta, or the others
+         *      buckets: Buckets to file improved actors into
+         *
+         */
+		void relaxAll(const vector<int>& actors, bool light,
+		                                      vector<vector<int>>& buckets);
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      adjacency: Graph built with weights, must outlive the object
+         *      threads: Number of worker threads, 0 for one per core
+         *      width: Bucket width, 0 to derive it from the weight range
+         *             and the average degree
+         */
+		DeltaStepping(const Adjacency& adjacency, int threads, int width);
+
+        /**
+         * Destructor
+         */
+		~DeltaStepping();
+
+        /**
+         * Bucket width in use
+         *
+         * Return: delta
+         */
+		int bucketWidth() const;
+
+        /**
+         * Shortest weighted distance from one actor to every actor
+         * Parameters:
+         *      source: index of the Actor to start from
+         *      dist: Filled with the distances, INT_MAX if not reached
+         *      prev: Filled with the previous actor on a shortest path,
+         *            -1 for the source and for actors not reached
+         *
+         */
+		void run(int source, vector<int>& dist, vector<int>& prev);
+};
+
+#endif // DELTASTEPPING_H
@@ -0,0 +1,339 @@
+/*
+ * EdgeList.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 3, 2016
+ *
+ * Implements the edge list loading declared in EdgeList.h.
+ */
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "EdgeList.h"
+
+using namespace std;
+
+#define CACHE_MAGIC 0x4c455452     // "RTEL"
+#define CACHE_VERSION 2
+#define RADIX_BITS 16
+
+/**
+ * Whether the 8 bytes of a word are all ASCII digits
+ */
+static inline bool eightDigits(uint64_t word){
+	return ((word & 0xF0F0F0F0F0F0F0F0ULL) |
+	        (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+	       == 0x3333333333333333ULL;
+}
+
+/**
+ * Value of 8 ASCII digits loaded little endian into a word, combining
+ * pairs, then quads, then the two halves with a few multiplications
+ */
+static inline uint64_t eightDigitValue(uint64_t word){
+	word -= 0x3030303030303030ULL;
+	word = word * 10 + (word >> 8);
+	return (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+	        (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))))
+	       >> 32;
+}
+
+/**
+ * Parses the whitespace separated integers of a range of the file. Runs of
+ * 8 digits are converted a word at a time.
+ * Parameters:
+ *      curr: Start of the range
+ *      end: End of the range
+ *      values: The integers found are appended here
+ *
+ */
+static void parseRange(const char * curr, const char * end,
+                                                       vector<int>& values){
+	while (curr < end){
+		if (*curr != '-' && (*curr < '0' || *curr > '9')){
+			curr++;
+			continue;
+		}
+		bool negative = (*curr == '-');
+		if (negative)
+			curr++;
+
+		uint64_t value = 0;
+		uint64_t word;
+		while (end - curr >= 8){
+			memcpy(&word, curr, 8);
+			if (!eightDigits(word))
+				break;
+			value = value * 100000000 + eightDigitValue(word);
+			curr += 8;
+		}
+		while (curr < end && *curr >= '0' && *curr <= '9')
+			value = value * 10 + (*curr++ - '0');
+		values.push_back(negative ? -(int)value : (int)value);
+	}
+}
+
+/**
+ * Constructor
+ * Parameters:
+ *      threads: Number of worker threads, 0 for one per core
+ */
+EdgeList::EdgeList(int threads){
+	numThreads = resolveThreads(threads);
+}
+
+/**
+ * Reads "retweeter original" pairs of user ids from a text file. The file
+ * is mapped into memory and split at line boundaries, one range per thread.
+ * The same workers go on to compact the ids.
+ * Parameters:
+ *      in_filename: File to read
+ *
+ * Return: true if the file was read, false otherwise
+ */
+bool EdgeList::loadText(const char * in_filename){
+	int fd = open(in_filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) < 0){
+		close(fd);
+		return false;
+	}
+	size_t length = info.st_size;
+	const char * data = NULL;
+	if (length){
+		void * mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED){
+			close(fd);
+			return false;
+		}
+		madvise(mapped, length, MADV_SEQUENTIAL);
+		data = (const char *)mapped;
+	}
+	close(fd);
+
+	// range t starts at the first line starting at or after t/T of the file
+	vector<size_t> bounds(numThreads + 1, length);
+	for (int t = 0; t < numThreads; t++){
+		size_t start = length * t / numThreads;
+		while (start > 0 && start < length && data[start - 1] != '\n')
+			start++;
+		bounds[t] = start;
+	}
+
+	WorkerPool pool(numThreads);
+	vector<vector<int>> values(numThreads);
+	pool.run([&](int t){
+		parseRange(data + bounds[t], data + bounds[t + 1], values[t]);
+	});
+	if (length)
+		munmap((void *)data, length);
+
+	// every line holds one edge, so each range holds whole pairs
+	tails.clear();
+	heads.clear();
+	for (vector<int>& range : values){
+		for (size_t k = 0; k + 1 < range.size(); k += 2){
+			tails.push_back(range[k]);
+			heads.push_back(range[k + 1]);
+		}
+		vector<int>().swap(range);
+	}
+	compact(pool);
+	return true;
+}
+
+/**
+ * Replaces the user ids in tails and heads by dense indices and fills
+ * userID. Ids are sorted with a parallel LSD radix sort and deduplicated,
+ * then every endpoint is looked up in the sorted ids.
+ * Parameters:
+ *      pool: Workers to run the passes on
+ *
+ */
+void EdgeList::compact(WorkerPool& pool){
+	size_t count = tails.size() + heads.size();
+	vector<uint32_t> keys(count);
+	vector<uint32_t> sorted(count);
+	for (size_t k = 0; k < tails.size(); k++){
+		// flipping the sign bit orders negative ids first
+		keys[2 * k] = (uint32_t)tails[k] ^ 0x80000000u;
+		keys[2 * k + 1] = (uint32_t)heads[k] ^ 0x80000000u;
+	}
+
+	const int buckets = 1 << RADIX_BITS;
+	vector<vector<size_t>> position(numThreads, vector<size_t>(buckets));
+	for (int shift = 0; shift < 32; shift += RADIX_BITS){
+		// every thread counts the digits of its slice
+		pool.run([&](int t){
+			vector<size_t>& counts = position[t];
+			fill(counts.begin(), counts.end(), 0);
+			size_t begin = count * t / numThreads;
+			size_t end = count * (t + 1) / numThreads;
+			for (size_t k = begin; k < end; k++)
+				counts[(keys[k] >> shift) & (buckets - 1)]++;
+		});
+
+		// slices keep their order within a digit, so the sort is stable
+		size_t offset = 0;
+		for (int digit = 0; digit < buckets; digit++){
+			for (int t = 0; t < numThreads; t++){
+				size_t slots = position[t][digit];
+				position[t][digit] = offset;
+				offset += slots;
+			}
+		}
+
+		pool.run([&](int t){
+			vector<size_t>& next = position[t];
+			size_t begin = count * t / numThreads;
+			size_t end = count * (t + 1) / numThreads;
+			for (size_t k = begin; k < end; k++)
+				sorted[next[(keys[k] >> shift) & (buckets - 1)]++] = keys[k];
+		});
+		keys.swap(sorted);
+	}
+	vector<uint32_t>().swap(sorted);
+	keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+	userID.resize(keys.size());
+	for (size_t k = 0; k < keys.size(); k++)
+		userID[k] = (int)(keys[k] ^ 0x80000000u);
+
+	pool.run([&](int t){
+		size_t begin = tails.size() * t / numThreads;
+		size_t end = tails.size() * (t + 1) / numThreads;
+		for (size_t k = begin; k < end; k++){
+			tails[k] = lower_bound(userID.begin(), userID.end(), tails[k])
+			           - userID.begin();
+			heads[k] = lower_bound(userID.begin(), userID.end(), heads[k])
+			           - userID.begin();
+		}
+	});
+}
+
+/**
+ * Identity of the text file a cache is made from: its resolved path, and
+ * its size and modification time to the nanosecond
+ * Parameters:
+ *      in_filename: Text file
+ *      path: Set to the resolved path
+ *      stamp: Set to the size, the seconds and the nanoseconds of the
+ *             modification time
+ *
+ * Return: true if the file could be looked up, false otherwise
+ */
+static bool sourceOf(const char * in_filename, string& path,
+                                                       int64_t stamp[3]){
+	struct stat info;
+	char resolved[PATH_MAX];
+	if (stat(in_filename, &info) < 0 || !realpath(in_filename, resolved))
+		return false;
+	path = resolved;
+	stamp[0] = info.st_size;
+	stamp[1] = info.st_mtim.tv_sec;
+	stamp[2] = info.st_mtim.tv_nsec;
+	return true;
+}
+
+/**
+ * Reads a binary cache written by saveCache. The cache is only used if it
+ * was made from the same path, and the file still has the size and the
+ * modification time it had then.
+ * Parameters:
+ *      cache_filename: Cache to read
+ *      in_filename: Text file the cache was made from
+ *
+ * Return: true if the cache was read, false otherwise
+ */
+bool EdgeList::loadCache(const char * cache_filename,
+                                                  const char * in_filename){
+	string path;
+	int64_t stamp[3];
+	if (!sourceOf(in_filename, path, stamp))
+		return false;
+
+	FILE * file = fopen(cache_filename, "rb");
+	if (!file)
+		return false;
+	uint32_t header[3];
+	string cachedPath;
+	int64_t cachedStamp[3];
+	int64_t sizes[2];
+	bool valid = fread(header, sizeof(header), 1, file) == 1 &&
+	             header[0] == CACHE_MAGIC && header[1] == CACHE_VERSION &&
+	             header[2] == path.size();
+	if (valid){
+		cachedPath.resize(header[2]);
+		valid = fread(&cachedPath[0], 1, header[2], file) == header[2] &&
+		        cachedPath == path &&
+		        fread(cachedStamp, sizeof(cachedStamp), 1, file) == 1 &&
+		        !memcmp(cachedStamp, stamp, sizeof(cachedStamp)) &&
+		        fread(sizes, sizeof(sizes), 1, file) == 1 &&
+		        sizes[0] >= 0 && sizes[1] >= 0;
+	}
+	if (valid){
+		userID.resize(sizes[0]);
+		tails.resize(sizes[1]);
+		heads.resize(sizes[1]);
+		valid = fread(userID.data(), sizeof(int), sizes[0], file)
+		                                                  == (size_t)sizes[0] &&
+		        fread(tails.data(), sizeof(int), sizes[1], file)
+		                                                  == (size_t)sizes[1] &&
+		        fread(heads.data(), sizeof(int), sizes[1], file)
+		                                                  == (size_t)sizes[1];
+	}
+	fclose(file);
+	if (!valid){
+		userID.clear();
+		tails.clear();
+		heads.clear();
+	}
+	return valid;
+}
+
+/**
+ * Writes the edges as a binary cache: magic, version, length of the text
+ * file's path, the path, its size and modification time, number of users,
+ * number of edges, then userID, tails and heads as raw ints
+ * Parameters:
+ *      cache_filename: Cache to write
+ *      in_filename: Text file the edges were read from
+ *
+ * Return: true if the cache was written, false otherwise
+ */
+bool EdgeList::saveCache(const char * cache_filename,
+                                            const char * in_filename) const {
+	string path;
+	int64_t stamp[3];
+	if (!sourceOf(in_filename, path, stamp))
+		return false;
+
+	FILE * file = fopen(cache_filename, "wb");
+	if (!file)
+		return false;
+	uint32_t header[3] = { CACHE_MAGIC, CACHE_VERSION,
+	                       (uint32_t)path.size() };
+	int64_t sizes[2] = { (int64_t)userID.size(), (int64_t)tails.size() };
+	bool written = fwrite(header, sizeof(header), 1, file) == 1 &&
+	               fwrite(path.data(), 1, path.size(), file) == path.size() &&
+	               fwrite(stamp, sizeof(int64_t), 3, file) == 3 &&
+	               fwrite(sizes, sizeof(sizes), 1, file) == 1 &&
+	               fwrite(userID.data(), sizeof(int), userID.size(), file)
+	                                                     == userID.size() &&
+	               fwrite(tails.data(), sizeof(int), tails.size(), file)
+	                                                     == tails.size() &&
+	               fwrite(heads.data(), sizeof(int), heads.size(), file)
+	                                                     == heads.size();
+	return fclose(file) == 0 && written;
+}
@@ -0,0 +1,91 @@
+/*
+ * EdgeList.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 3, 2016
+ *
+ * Defines the EdgeList class used by the extension to load retweet edges.
+ * The text file is mapped into memory and parsed by several threads, and
+ * the sparse user ids are compacted into dense indices 0..n-1 by a radix
+ * sort. The result can be saved as a binary cache that later runs load
+ * directly.
+ */
+
+#ifndef EDGELIST_H
+#define EDGELIST_H
+
+#include <functional>
+#include <vector>
+#include "ParallelFor.hpp"
+
+using namespace std;
+
+/**
+ * Retweet edges between users identified by dense indices
+ */
+class EdgeList {
+	private:
+		int numThreads;            // worker threads
+
+        /**
+         * Replaces the user ids in tails and heads by dense indices and
+         * fills userID
+         * Parameters:
+         *      pool: Workers to run the passes on
+         *
+         */
+		void compact(WorkerPool& pool);
+
+	public:
+		vector<int> userID;        // dense index to user id, ascending
+		vector<int> tails;         // users who retweeted
+		vector<int> heads;         // users who were retweeted
+
+        /**
+         * Constructor
+         * Parameters:
+         *      threads: Number of worker threads, 0 for one per core
+         */
+		EdgeList(int threads);
+
+        /**
+         * Number of users
+         *
+         * Return: Number of distinct user ids
+         */
+		int size() const { return userID.size(); }
+
+        /**
+         * Reads "retweeter original" pairs of user ids from a text file
+         * Parameters:
+         *      in_filename: File to read
+         *
+         * Return: true if the file was read, false otherwise
+         */
+		bool loadText(const char * in_filename);
+
+        /**
+         * Reads a binary cache written by saveCache. A cache is only used
+         * for the path it was made from, while that file keeps the size
+         * and modification time it had.
+         * Parameters:
+         *      cache_filename: Cache to read
+         *      in_filename: Text file the cache was made from
+         *
+         * Return: true if the cache was read, false otherwise
+         */
+		bool loadCache(const char * cache_filename, const char * in_filename);
+
+        /**
+         * Writes the edges as a binary cache, along with the path, size
+         * and modification time of the text file they came from
+         * Parameters:
+         *      cache_filename: Cache to write
+         *      in_filename: Text file the edges were read from
+         *
+         * Return: true if the cache was written, false otherwise
+         */
+		bool saveCache(const char * cache_filename,
+		               const char * in_filename) const;
+};
+
+#endif // EDGELIST_H
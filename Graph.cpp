@@ -11,9 +11,9 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <set>
 #include <stack> 
 #include <climits>
+#include <algorithm>
 #include <unordered_map>
 #include "Graph.h"
 
@@ -22,27 +22,24 @@ using namespace std;
 /**
  * Default Graph constructor
  */ 
-Graph::Graph(void) {}
+Graph::Graph(void) : numNodes(0), visited(NULL), offsets(NULL),
+                     targets(NULL) {}
 
 /**
- * Graph copy constructor
- * Parameters: A graph of which the nodeSet is copied 
- *
+ * Graph destructor, the arena frees every array at once
  */ 
-
-Graph::Graph(const Graph& graph){
-	nodeSet = graph.nodeSet;
-}
+Graph::~Graph(void){}
 
 /**
- * Graph destructor
- */ 
-Graph::~Graph(void){
-	for (auto& node : nodeSet){
-		if (node.second){ 
-			delete node.second;
-		}		
-	}
+ * Creates the per-user arrays
+ * Parameters:
+ *      count: Number of users
+ *
+ */
+void Graph::createNodes(int count){
+	numNodes = count;
+	visited = arena.allocate<bool>(count);
+	offsets = arena.allocate<int>(count + 1);
 }
 
 /**
@@ -58,7 +55,7 @@ stack<int> Graph::DFSTraversal(stack<int>& vertices){
 		int node = vertices.top();
 		vertices.pop();
 
-		if (!(nodeSet[node]->visited))
+		if (!(visited[node]))
 			DFSVisit(node, finished);
 
 	}
@@ -71,33 +68,28 @@ stack<int> Graph::DFSTraversal(stack<int>& vertices){
  * DFS traversal to find strongly connected components
  * Parameters: 
  *      vertices: Reference to stack of vertices to visit
+ *      component: Filled with the component id of every vertex, ids
+ *                 numbered in the order components are found
+ *      order: Filled with every vertex in the order the searches visited
+ *             them
  * 
- * Return: multiset of vertices with their strongly connected components
+ * Return: Number of strongly connected components
  */   
-multiset<vector<int>, vectorComp> Graph::DFSTraversalSCC(stack<int>& vertices){
-	multiset<vector<int>, vectorComp> scc;			// a stack of visited node
-	stack<int> finished;
+int Graph::DFSTraversalSCC(stack<int>& vertices, vector<int>& component,
+                                                        vector<int>& order){
+	int count = 0;			// components found so far
+	vector<pair<int,int>> pending;	// scratch stack shared by every search
+	component.assign(numNodes, -1);
+	order.clear();
+	order.reserve(numNodes);
 	while (!vertices.empty()){
-		vector<int> currentSCC;
 		int node = vertices.top();
 		vertices.pop();
 
-		if (!(nodeSet[node]->visited))
-			DFSVisit(node, finished, currentSCC);
-
-		if (currentSCC.size())
-		
-        
-		if (!(nodeSet[node]->visited)) { 
-			DFSVisit(node, finished, currentSCC);
-        }
-        
-		if (currentSCC.size()) {
-			scc.insert(currentSCC);
-        }
-        
+		if (!(visited[node]))
+			DFSLabel(node, count++, component, order, pending);
 	}
-	return scc;
+	return count;
 
 }
 
@@ -109,65 +101,146 @@ multiset<vector<int>, vectorComp> Graph::DFSTraversalSCC(stack<int>& vertices){
  *
  */ 
 void Graph::DFSVisit(int vertex, stack<int>& finished){
-	nodeSet[vertex]->visited = true;
-	for (int neighbor : nodeSet[vertex]->edgeSet){
-		if (!(nodeSet[neighbor]->visited))
-			DFSVisit(neighbor,finished);
+	visited[vertex] = true;
+	for (int k = offsets[vertex]; k < offsets[vertex + 1]; k++){
+		if (!(visited[targets[k]]))
+			DFSVisit(targets[k],finished);
 	}
 
 	finished.push(vertex);
 }
 
 /**
- * Visits current vertex and runs DFS from vertex. Called form DFStraversalSCC
+ * Labels every vertex reachable from vertex that has not been visited yet.
+ * The search keeps its own stack of vertices and the next edge of each, so
+ * deep components do not exhaust the call stack, and visits the vertices
+ * in the order a recursive DFS does. Called from DFSTraversalSCC
  * Parameters:
- *      vertex: current vertex being visited
- *      currentSCC: current strongly connected component being searched 
+ *      vertex: Vertex to start from
+ *      label: Component id to give the vertices
+ *      component: Component id of every vertex
+ *      order: The vertices are appended in the order visited
+ *      pending: Scratch stack of the search, left empty
  *    
  */ 
-void Graph::DFSVisit(int vertex, stack<int>& finished,vector<int>& currentSCC){
-
-	currentSCC.push_back(vertex);
-
-	nodeSet[vertex]->visited = true;
-	for (int neighbor : nodeSet[vertex]->edgeSet){
-		if (!(nodeSet[neighbor]->visited))
-			DFSVisit(neighbor,finished, currentSCC);
+void Graph::DFSLabel(int vertex, int label, vector<int>& component,
+                     vector<int>& order, vector<pair<int,int>>& pending){
+	visited[vertex] = true;
+	component[vertex] = label;
+	order.push_back(vertex);
+	pending.push_back(make_pair(vertex, offsets[vertex]));
+	while (!pending.empty()){
+		int curr = pending.back().first;
+		int& k = pending.back().second;
+		if (k == offsets[curr + 1]){
+			pending.pop_back();
+			continue;
+		}
+		int neighbor = targets[k++];
+		if (!(visited[neighbor])){
+			visited[neighbor] = true;
+			component[neighbor] = label;
+			order.push_back(neighbor);
+			pending.push_back(make_pair(neighbor, offsets[neighbor]));
+		}
 	}
-
-	finished.push(vertex);
 }
+
 /**
- * Creates entire graph at once for pathfinder
+ * Condensation DAG: one vertex per component and one edge per pair of
+ * components joined by at least one edge. Edges are bucketed by source
+ * component with a counting sort and duplicates dropped with a marker per
+ * target, so the whole build is O(V + E).
  * Parameters:
- *      map: Map with pairs of Movie and vector of Actor indices
+ *      edges: Edges read from file, by dense user index
+ *      component: Component id of every vertex
+ *      count: Number of components
+ *      dag: Filled with the edges between components, each once
  *
  */
-void Graph::createGraph(vector<pair<int,int>>& dataSet){
-	for (auto& pair : dataSet){
-		nodeSet[pair.first]->edgeSet.push_back(pair.second);
+void Graph::condensation(const EdgeList& edges, const vector<int>& component,
+                                          int count, Adjacency& dag) const {
+	// bucket the edges leaving each component
+	vector<int> start(count + 1, 0);
+	for (size_t k = 0; k < edges.tails.size(); k++)
+		start[component[edges.tails[k]] + 1]++;
+	for (int comp = 0; comp < count; comp++)
+		start[comp + 1] += start[comp];
+	vector<int> heads(start[count]);
+	vector<int> next(start.begin(), start.end() - 1);
+	for (size_t k = 0; k < edges.tails.size(); k++)
+		heads[next[component[edges.tails[k]]]++] =
+		                                           component[edges.heads[k]];
+
+	// keep each target once per source, skipping edges inside a component
+	vector<int> seen(count, -1);
+	dag.offsets.assign(1, 0);
+	dag.targets.clear();
+	dag.weights.clear();
+	for (int comp = 0; comp < count; comp++){
+		seen[comp] = comp;
+		for (int k = start[comp]; k < start[comp + 1]; k++){
+			if (seen[heads[k]] != comp){
+				seen[heads[k]] = comp;
+				dag.targets.push_back(heads[k]);
+			}
+		}
+		dag.offsets.push_back(dag.targets.size());
 	}
 }
 
+/**
+ * Creates entire graph at once
+ * Parameters:
+ *      edges: Edges read from file, by dense user index
+ *
+ */
+void Graph::createGraph(const EdgeList& edges){
+	fillEdges(edges.tails, edges.heads);
+}
+
 /**
  * Creates transpose graph to find SCC
  * Parameters:
- *      dataSet: Edges read read from file
+ *      edges: Edges read from file, by dense user index
  *
  */  
-void Graph::createTransposeGraph(vector<pair<int,int>>& dataSet){
-	for (auto& pair : dataSet){
-		nodeSet[pair.second]->edgeSet.push_back(pair.first);
-	}
+void Graph::createTransposeGraph(const EdgeList& edges){
+	fillEdges(edges.heads, edges.tails);
+}
+
+/**
+ * Fills the compressed edge lists with a counting sort by source, keeping
+ * the file order of the edges of each user. The target array is allocated
+ * by the first call and reused by the transpose, which has as many edges.
+ * Parameters:
+ *      sources: Source of every edge
+ *      destinations: Destination of every edge
+ *
+ */
+void Graph::fillEdges(const vector<int>& sources,
+                                         const vector<int>& destinations){
+	if (!targets)
+		targets = arena.allocate<int>(sources.size());
+
+	fill_n(offsets, numNodes + 1, 0);
+	for (int source : sources)
+		offsets[source + 1]++;
+	for (int node = 0; node < numNodes; node++)
+		offsets[node + 1] += offsets[node];
+
+	// offsets[node] walks to the end of the node's edges and is put back
+	for (size_t k = 0; k < sources.size(); k++)
+		targets[offsets[sources[k]]++] = destinations[k];
+	for (int node = numNodes; node > 0; node--)
+		offsets[node] = offsets[node - 1];
+	offsets[0] = 0;
 }
 
 /**
  * Clears edgeset of each pair before creating transpose
  */ 
 void Graph::clearGraph(){
-	for (auto& pair : nodeSet){
-		pair.second->edgeSet.clear();
-		pair.second->visited = false;
-	}
+	fill_n(visited, numNodes, false);
 }
 
@@ -12,64 +12,58 @@
 #include <iostream>
 #include <vector>
 #include <stack>
-#include <set>
 #include <unordered_map>
-#include "Node.h"
+#include "Adjacency.h"
+#include "Arena.hpp"
+#include "EdgeList.h"
 
 using namespace std;
 
-/**
- * A function class to compare movies. 
- * Parameters:
- *      lhs: left hand movie reference
- *      rhs: right hand movie reference
- *
- * return: True if lhs is lesser, false if otherwise
- */ 
-class vectorComp {
-	public:
-        /**
-         * Overloaded compare operator to compare movies
-         * Parameters:
-         *      lhs: left hand movie reference
-         *      rhs: right hand movie reference
-         * 
-         * Return: True is lhs movie_year is smaller, false if otherwise
-         */      
-		bool operator()(const vector<int>& lhs, 
-                                            const vector<int>& rhs) const {
-			return lhs.size() > rhs.size();
-		}
-};
-
 /** 
- * Class for graph data structure used in extension
+ * Class for graph data structure used in extension. Users are dense
+ * indices; the visited flags and the compressed edge lists are arrays in an
+ * arena, so there is no object per user and teardown frees a few blocks.
  */ 
 class Graph {
-    friend class Node;
 	private:
+		Arena arena;          // owns the arrays below
+		int numNodes;         // number of users
+		bool * visited;       // status of each user in the DFS
+		int * offsets;        // start of each user's edges, numNodes + 1
+		int * targets;        // edges of every user, by source
 
+        /**
+         * Fills the compressed edge lists with a counting sort by source,
+         * keeping the file order of the edges of each user
+         * Parameters:
+         *      sources: Source of every edge
+         *      destinations: Destination of every edge
+         *
+         */
+		void fillEdges(const vector<int>& sources,
+		                                      const vector<int>& destinations);
 
 	public:
-		 unordered_map<int, Node *> nodeSet;     //underlying data structure for ActorGraph
-		
         /**
 		 * Default constructor for graph object
 		 */ 
 		Graph(void);
-
-        /**
-         * Graph constructor
-         * Parameters: Hash map of all Node objects 
-         *
-         */ 
-		Graph(const Graph& graph);
         
         /**
          * Destructor for graph
          */ 
 		~Graph(void);
 
+		Graph(const Graph&) = delete;
+		Graph& operator=(const Graph&) = delete;
+
+        /**
+         * Creates the per-user arrays
+         * Parameters:
+         *      count: Number of users
+         *
+         */
+		void createNodes(int count);
 
         /**
          * Clears edgeset of each pair before creating transpose
@@ -77,20 +71,20 @@ class Graph {
 		void clearGraph();
 
         /**
-         * Creates entire graph at once for pathfinder
+         * Creates entire graph at once
          * Parameters:
-         *      map: Map with pairs of Movie and vector of Actor indices
+         *      edges: Edges read from file, by dense user index
          *
          */
-		void createGraph( vector<pair<int,int> >& dataSet);
+		void createGraph(const EdgeList& edges);
 
         /**
          * Creates transpose graph to find SCC
          * Parameters:
-         *      dataSet: Edges read read from file
+         *      edges: Edges read from file, by dense user index
          *
          */ 		
-		void createTransposeGraph( vector <pair<int,int> >& dataSet);
+		void createTransposeGraph(const EdgeList& edges);
 
         /**
          * Visits current vertex and runs DFS from vertex. Called from DFS 
@@ -103,14 +97,18 @@ class Graph {
 		void DFSVisit(int vertex, stack<int>& finished);
 
         /**
-         * Visits current vertex and runs DFS from vertex. Called from DFS 
-         * traversal
+         * Labels every vertex reachable from vertex that has not been
+         * visited yet. Called from DFSTraversalSCC
          * Parameters:
-         *      vertex: Current vertex being visited
-         *      finished: Stack of verticies already visited
+         *      vertex: Vertex to start from
+         *      label: Component id to give the vertices
+         *      component: Component id of every vertex
+         *      order: The vertices are appended in the order visited
+         *      pending: Scratch stack of the search, left empty
          *
          */ 
-		void DFSVisit(int vertex, stack<int>& finished, vector<int>& currentSCC);
+		void DFSLabel(int vertex, int label, vector<int>& component,
+		              vector<int>& order, vector<pair<int,int>>& pending);
 		
         /**
          * DFS traversal to find every vertex in graph. 
@@ -125,11 +123,28 @@ class Graph {
          * DFS traversal to find strongly connected components
          * Parameters: 
          *      vertices: Reference to stack of vertices to visit
+         *      component: Filled with the component id of every vertex,
+         *                 ids numbered in the order components are found
+         *      order: Filled with every vertex in the order the searches
+         *             visited them
          * 
-         * Return: multiset of vertices with its strongly connected components
+         * Return: Number of strongly connected components
          */ 
+		int DFSTraversalSCC(stack<int>& vertices, vector<int>& component,
+		                                                 vector<int>& order);
 
-		multiset<vector<int>, vectorComp> DFSTraversalSCC(stack<int>& vertices);
+        /**
+         * Condensation DAG: one vertex per component and one edge per pair
+         * of components joined by at least one edge
+         * Parameters:
+         *      edges: Edges read from file, by dense user index
+         *      component: Component id of every vertex
+         *      count: Number of components
+         *      dag: Filled with the edges between components, each once
+         *
+         */
+		void condensation(const EdgeList& edges, const vector<int>& component,
+		                                        int count, Adjacency& dag) const;
 
 };
 
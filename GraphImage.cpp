@@ -0,0 +1,378 @@
+/*
+ * GraphImage.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 9, 2016
+ *
+ * Implements the shared graph image declared in GraphImage.h.
+ */
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GraphImage.h"
+
+using namespace std;
+
+#define IMAGE_MAGIC 0x4d494752     // "RGIM"
+#define IMAGE_VERSION 1
+
+/**
+ * Rounds a byte offset up to the next multiple of 8
+ * Parameters:
+ *      offset: Byte offset
+ *
+ * Return: Aligned offset
+ */
+static int64_t align(int64_t offset){
+	return (offset + 7) & ~(int64_t)7;
+}
+
+/**
+ * 64 bit FNV-1a hash of an actor name, for the name table
+ * Parameters:
+ *      name: Name to hash
+ *      length: Bytes in the name
+ *
+ * Return: Hash of the name
+ */
+static uint64_t hashName(const char * name, size_t length){
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < length; i++){
+		hash ^= (unsigned char)name[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * Whether a name is a POSIX shared memory segment, like "/pa4graph" with a
+ * single leading slash; any other name is a file
+ * Parameters:
+ *      name: Segment or file name
+ *
+ * Return: true for a segment, false for a file
+ */
+static bool isSegment(const char * name){
+	return name[0] == '/' && !strchr(name + 1, '/');
+}
+
+/**
+ * Opens a POSIX shared memory segment or a file, see isSegment
+ * Parameters:
+ *      name: Segment or file name
+ *      flags: Flags of open
+ *
+ * Return: File descriptor, -1 on failure
+ */
+static int openImage(const char * name, int flags){
+	if (isSegment(name))
+		return shm_open(name, flags, 0644);
+	return open(name, flags, 0644);
+}
+
+/**
+ * Removes the name of a segment or a file. Processes that mapped it keep
+ * their mapping until they unmap it.
+ * Parameters:
+ *      name: Segment or file name
+ *
+ */
+static void removeImage(const char * name){
+	if (isSegment(name))
+		shm_unlink(name);
+	else
+		unlink(name);
+}
+
+/**
+ * Default constructor, nothing attached
+ */
+GraphImage::GraphImage(void) : base(NULL), length(0), header(NULL) {}
+
+/**
+ * Destructor, unmaps the image
+ */
+GraphImage::~GraphImage(){
+	if (base)
+		munmap((void *)base, length);
+}
+
+/**
+ * Writes a graph with no pending deltas as an image
+ * Parameters:
+ *      graph: Graph to write
+ *      name: Segment or file name
+ *
+ * Return: true if the image was written, false otherwise
+ */
+bool GraphImage::save(const ActorGraph& graph, const char * name){
+	int64_t actors = graph.size();
+	int64_t movies = graph.movieCount();
+	int64_t nameLength = 0;
+	int64_t edges = 0;
+	for (int actor = 0; actor < actors; actor++){
+		nameLength += strlen(graph.nameOf(actor)) + 1;
+		edges += graph.degreeOf(actor);
+	}
+	int64_t titleLength = 0;
+	for (int movie = 0; movie < movies; movie++)
+		titleLength += strlen(graph.titleOf(movie)) + 1;
+	int64_t slots = 1;
+	while (slots < 2 * actors)
+		slots *= 2;
+
+	ImageHeader layout;
+	memset(&layout, 0, sizeof(layout));
+	layout.version = IMAGE_VERSION;
+	layout.actors = actors;
+	layout.edges = edges;
+	layout.movies = movies;
+	layout.slots = slots;
+	layout.nameOffsets = align(sizeof(ImageHeader));
+	layout.nameBytes = align(layout.nameOffsets +
+	                                      (actors + 1) * sizeof(int64_t));
+	layout.edgeOffsets = align(layout.nameBytes + nameLength);
+	layout.edgeList = align(layout.edgeOffsets +
+	                                      (actors + 1) * sizeof(int64_t));
+	layout.components = align(layout.edgeList + edges * sizeof(ActorEdge));
+	layout.titleOffsets = align(layout.components + actors * sizeof(int));
+	layout.titleBytes = align(layout.titleOffsets +
+	                                      (movies + 1) * sizeof(int64_t));
+	layout.years = align(layout.titleBytes + titleLength);
+	layout.nameSlots = align(layout.years + movies * sizeof(int));
+	layout.length = align(layout.nameSlots + slots * sizeof(int));
+
+	// processes attached to an older image keep reading its pages: a
+	// segment is unlinked and created anew, a file is written under a
+	// temporary name and renamed over the old one
+	string target(name);
+	if (isSegment(name))
+		shm_unlink(name);
+	else
+		target += ".tmp." + to_string(getpid());
+	int fd = openImage(target.c_str(), O_RDWR | O_CREAT | O_EXCL);
+	if (fd < 0)
+		return false;
+	if (ftruncate(fd, layout.length) != 0){
+		close(fd);
+		removeImage(target.c_str());
+		return false;
+	}
+	char * image = (char *)mmap(NULL, layout.length, PROT_READ | PROT_WRITE,
+	                                                      MAP_SHARED, fd, 0);
+	close(fd);
+	if (image == MAP_FAILED){
+		removeImage(target.c_str());
+		return false;
+	}
+
+	int64_t * nameOffsets = (int64_t *)(image + layout.nameOffsets);
+	char * nameBytes = image + layout.nameBytes;
+	int64_t * edgeOffsets = (int64_t *)(image + layout.edgeOffsets);
+	ActorEdge * edgeList = (ActorEdge *)(image + layout.edgeList);
+	int * components = (int *)(image + layout.components);
+	int * nameSlots = (int *)(image + layout.nameSlots);
+	nameOffsets[0] = 0;
+	edgeOffsets[0] = 0;
+	memset(nameSlots, 0xff, slots * sizeof(int));
+	for (int actor = 0; actor < actors; actor++){
+		const char * actorName = graph.nameOf(actor);
+		size_t size = strlen(actorName);
+		memcpy(nameBytes + nameOffsets[actor], actorName, size + 1);
+		nameOffsets[actor + 1] = nameOffsets[actor] + size + 1;
+
+		int64_t edge = edgeOffsets[actor];
+		for (const ActorEdge& costar : graph.edgesOf(actor))
+			edgeList[edge++] = costar;
+		edgeOffsets[actor + 1] = edge;
+		components[actor] = graph.componentOf(actor);
+
+		// the first actor with a name keeps it, like the name index
+		uint64_t slot = hashName(actorName, size) & (slots - 1);
+		for (; nameSlots[slot] >= 0; slot = (slot + 1) & (slots - 1))
+			if (!strcmp(nameBytes + nameOffsets[nameSlots[slot]], actorName))
+				break;
+		if (nameSlots[slot] < 0)
+			nameSlots[slot] = actor;
+	}
+
+	int64_t * titleOffsets = (int64_t *)(image + layout.titleOffsets);
+	char * titleBytes = image + layout.titleBytes;
+	int * years = (int *)(image + layout.years);
+	titleOffsets[0] = 0;
+	for (int movie = 0; movie < movies; movie++){
+		const char * movieTitle = graph.titleOf(movie);
+		size_t size = strlen(movieTitle) + 1;
+		memcpy(titleBytes + titleOffsets[movie], movieTitle, size);
+		titleOffsets[movie + 1] = titleOffsets[movie] + size;
+		years[movie] = graph.yearOf(movie);
+	}
+
+	// the magic marks the image complete, after everything else
+	memcpy(image, &layout, sizeof(layout));
+	atomic_thread_fence(memory_order_release);
+	((ImageHeader *)image)->magic = IMAGE_MAGIC;
+	bool written = msync(image, layout.length, MS_SYNC) == 0;
+	written = munmap(image, layout.length) == 0 && written;
+	if (written && target != name)
+		written = rename(target.c_str(), name) == 0;
+	if (!written)
+		removeImage(target.c_str());
+	return written;
+}
+
+/**
+ * Maps an image read only and checks its header
+ * Parameters:
+ *      name: Segment or file name
+ *
+ * Return: true if a complete image was mapped, false otherwise
+ */
+bool GraphImage::attach(const char * name){
+	if (base)
+		return false;
+	int fd = openImage(name, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(ImageHeader)){
+		close(fd);
+		return false;
+	}
+	void * mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	const ImageHeader * found = (const ImageHeader *)mapping;
+	if (found->magic != IMAGE_MAGIC || found->version != IMAGE_VERSION ||
+	                                      found->length != info.st_size){
+		munmap(mapping, info.st_size);
+		return false;
+	}
+	atomic_thread_fence(memory_order_acquire);
+	segment = name;
+	base = (const char *)mapping;
+	length = info.st_size;
+	header = found;
+	return true;
+}
+
+/**
+ * Name the image was attached by
+ *
+ * Return: Segment or file name
+ */
+const string& GraphImage::name() const {
+	return segment;
+}
+
+/**
+ * Number of actors
+ *
+ * Return: Number of actors in the image
+ */
+int GraphImage::actors() const {
+	return header->actors;
+}
+
+/**
+ * Number of directed edges
+ *
+ * Return: Number of edges in the image
+ */
+long GraphImage::edges() const {
+	return header->edges;
+}
+
+/**
+ * Number of movies
+ *
+ * Return: Number of movies in the image
+ */
+int GraphImage::movies() const {
+	return header->movies;
+}
+
+/**
+ * Name of an actor
+ * Parameters:
+ *      actor: index of Actor
+ *
+ * Return: Name, ending in '\0'
+ */
+const char * GraphImage::actorName(int actor) const {
+	return section<char>(header->nameBytes) +
+	                          section<int64_t>(header->nameOffsets)[actor];
+}
+
+/**
+ * Start of every actor's edges in edgeList
+ *
+ * Return: Array of actors + 1 offsets
+ */
+const int64_t * GraphImage::edgeOffsets() const {
+	return section<int64_t>(header->edgeOffsets);
+}
+
+/**
+ * Edges of every actor, one after the other
+ *
+ * Return: Array of edges
+ */
+const ActorEdge * GraphImage::edgeList() const {
+	return section<ActorEdge>(header->edgeList);
+}
+
+/**
+ * Component representative of every actor
+ *
+ * Return: Array of actors entries
+ */
+const int * GraphImage::components() const {
+	return section<int>(header->components);
+}
+
+/**
+ * Title of a movie
+ * Parameters:
+ *      movie: index of Movie
+ *
+ * Return: Title, ending in '\0'
+ */
+const char * GraphImage::title(int movie) const {
+	return section<char>(header->titleBytes) +
+	                          section<int64_t>(header->titleOffsets)[movie];
+}
+
+/**
+ * Year of a movie
+ * Parameters:
+ *      movie: index of Movie
+ *
+ * Return: Release year
+ */
+int GraphImage::year(int movie) const {
+	return section<int>(header->years)[movie];
+}
+
+/**
+ * Looks an actor up by name, probing the name table from the slot of its
+ * hash until the actor or an empty slot
+ * Parameters:
+ *      name: Name of actor
+ *
+ * Return: Index of the first actor with the name, -1 if none
+ */
+int GraphImage::find(const string& name) const {
+	const int * nameSlots = section<int>(header->nameSlots);
+	uint64_t mask = header->slots - 1;
+	uint64_t slot = hashName(name.data(), name.size()) & mask;
+	for (; nameSlots[slot] >= 0; slot = (slot + 1) & mask)
+		if (name == actorName(nameSlots[slot]))
+			return nameSlots[slot];
+	return -1;
+}
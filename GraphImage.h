@@ -0,0 +1,202 @@
+/*
+ * GraphImage.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 9, 2016
+ *
+ * Defines the GraphImage class, a built actor graph laid out in one block
+ * of memory with offsets in place of pointers. The block is written once to
+ * a POSIX shared memory segment or a file; any number of processes map it
+ * read only and search it where it lies, so a host keeps one copy of the
+ * graph however many workers run, and a worker starts without parsing.
+ */
+
+#ifndef GRAPHIMAGE_H
+#define GRAPHIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ActorGraph.h"
+
+using namespace std;
+
+/**
+ * Header at the start of an image. Every section is an array at a byte
+ * offset from the start, aligned to 8 bytes.
+ *      nameOffsets:  int64_t[actors + 1], start of each name in nameBytes
+ *      nameBytes:    char[], the names, each ending in '\0'
+ *      edgeOffsets:  int64_t[actors + 1], start of each actor's edges
+ *      edges:        ActorEdge[edges], each actor's edges sorted by year
+ *      components:   int[actors], representative of each actor's component
+ *      titleOffsets: int64_t[movies + 1], start of each title in titleBytes
+ *      titleBytes:   char[], the titles, each ending in '\0'
+ *      years:        int[movies], year of each movie
+ *      nameSlots:    int[slots], open addressing table of actor indices
+ *                    hashed by name, -1 where empty
+ */
+struct ImageHeader{
+    uint32_t magic;         // IMAGE_MAGIC once the image is complete
+    uint32_t version;       // layout version
+    int64_t actors;         // number of actors
+    int64_t edges;          // number of directed edges
+    int64_t movies;         // number of movies
+    int64_t slots;          // size of the name table, a power of two
+    int64_t nameOffsets;    // byte offset of each section
+    int64_t nameBytes;
+    int64_t edgeOffsets;
+    int64_t edgeList;
+    int64_t components;
+    int64_t titleOffsets;
+    int64_t titleBytes;
+    int64_t years;
+    int64_t nameSlots;
+    int64_t length;         // bytes in the whole image
+};
+
+/**
+ * Read only mapping of a graph image
+ */
+class GraphImage {
+	private:
+		string segment;              // name the image was attached by
+		const char * base;           // start of the mapping
+		size_t length;               // bytes mapped
+		const ImageHeader * header;  // header at the start of the mapping
+
+        /**
+         * Array at a byte offset from the start of the mapping
+         * Parameters:
+         *      offset: Byte offset of the section
+         *
+         * Return: Pointer to the section
+         */
+		template<typename T>
+		const T * section(int64_t offset) const {
+			return (const T *)(base + offset);
+		}
+
+	public:
+        /**
+         * Default constructor, nothing attached
+         */
+		GraphImage(void);
+
+        /**
+         * Destructor, unmaps the image
+         */
+		~GraphImage();
+
+		GraphImage(const GraphImage&) = delete;
+		GraphImage& operator=(const GraphImage&) = delete;
+
+        /**
+         * Writes a graph with no pending deltas as an image. The magic is
+         * written last, so a reader never takes a partial image for a
+         * complete one. An image already under the name is replaced, not
+         * rewritten: processes attached to it keep reading it unchanged,
+         * and attach the new one by name.
+         * Parameters:
+         *      graph: Graph to write
+         *      name: Segment like "/pa4graph" for POSIX shared memory, any
+         *            other name is a file
+         *
+         * Return: true if the image was written, false otherwise
+         */
+		static bool save(const ActorGraph& graph, const char * name);
+
+        /**
+         * Maps an image read only
+         * Parameters:
+         *      name: Segment or file the image was written to
+         *
+         * Return: true if a complete image was mapped, false otherwise
+         */
+		bool attach(const char * name);
+
+        /**
+         * Name the image was attached by
+         *
+         * Return: Segment or file name
+         */
+		const string& name() const;
+
+        /**
+         * Number of actors
+         *
+         * Return: Number of actors in the image
+         */
+		int actors() const;
+
+        /**
+         * Number of directed edges
+         *
+         * Return: Number of edges in the image
+         */
+		long edges() const;
+
+        /**
+         * Number of movies
+         *
+         * Return: Number of movies in the image
+         */
+		int movies() const;
+
+        /**
+         * Name of an actor
+         * Parameters:
+         *      actor: index of Actor
+         *
+         * Return: Name, ending in '\0'
+         */
+		const char * actorName(int actor) const;
+
+        /**
+         * Start of every actor's edges in edgeList
+         *
+         * Return: Array of actors + 1 offsets
+         */
+		const int64_t * edgeOffsets() const;
+
+        /**
+         * Edges of every actor, one after the other
+         *
+         * Return: Array of edges
+         */
+		const ActorEdge * edgeList() const;
+
+        /**
+         * Component representative of every actor
+         *
+         * Return: Array of actors entries
+         */
+		const int * components() const;
+
+        /**
+         * Title of a movie
+         * Parameters:
+         *      movie: index of Movie
+         *
+         * Return: Title, ending in '\0'
+         */
+		const char * title(int movie) const;
+
+        /**
+         * Year of a movie
+         * Parameters:
+         *      movie: index of Movie
+         *
+         * Return: Release year
+         */
+		int year(int movie) const;
+
+        /**
+         * Looks an actor up by name in the name table
+         * Parameters:
+         *      name: Name of actor
+         *
+         * Return: Index of the first actor with the name, -1 if none
+         */
+		int find(const string& name) const;
+};
+
+#endif // GRAPHIMAGE_H
@@ -0,0 +1,241 @@
+/*
+ * IncrementalSCC.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 2, 2016
+ *
+ * Implements the incremental strongly connected components used by the
+ * streaming mode of the extension.
+ */
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <vector>
+#include "IncrementalSCC.h"
+
+using namespace std;
+
+/**
+ * Default constructor, empty graph
+ */
+IncrementalSCC::IncrementalSCC(void) : stamp(0), nextOrder(0),
+                                       numComponents(0), numEdges(0) {}
+
+/**
+ * Dense index of a user, adding the user if it is new. A new user is a
+ * component of its own placed after every other component.
+ * Parameters:
+ *      id: Id of the user
+ *
+ * Return: Dense index of the user
+ */
+int IncrementalSCC::node(int id){
+	auto it = indexOf.find(id);
+	if (it != indexOf.end())
+		return it->second;
+
+	int index = userID.size();
+	indexOf[id] = index;
+	userID.push_back(id);
+	parent.push_back(index);
+	setSize.push_back(1);
+	order.push_back(nextOrder++);
+	outEdges.push_back(vector<int>());
+	inEdges.push_back(vector<int>());
+	visited.push_back(-1);
+	numComponents++;
+	return index;
+}
+
+/**
+ * Component a user belongs to, with path halving
+ * Parameters:
+ *      index: Dense index of the user
+ *
+ * Return: Representative of the component
+ */
+int IncrementalSCC::find(int index){
+	while (parent[index] != index){
+		parent[index] = parent[parent[index]];
+		index = parent[index];
+	}
+	return index;
+}
+
+/**
+ * Collects the components reachable from start along out edges (or in
+ * edges) whose position lies within a bound
+ * Parameters:
+ *      start: Component to start from
+ *      forward: Follow out edges with position <= bound, or in edges with
+ *               position >= bound
+ *      bound: Position limit of the search
+ *      found: Filled with the components reached, start included
+ *
+ */
+void IncrementalSCC::search(int start, bool forward, int bound,
+                                                      vector<int>& found){
+	stamp++;
+	found.clear();
+	found.push_back(start);
+	visited[start] = stamp;
+
+	// found doubles as the stack of the search
+	for (size_t next = 0; next < found.size(); next++){
+		int curr = found[next];
+		vector<int>& edges = forward ? outEdges[curr] : inEdges[curr];
+		for (int user : edges){
+			int comp = find(user);
+			if (visited[comp] == stamp)
+				continue;
+			if (forward ? order[comp] > bound : order[comp] < bound)
+				continue;
+			visited[comp] = stamp;
+			found.push_back(comp);
+		}
+	}
+}
+
+/**
+ * Merges a set of components into one. Edges inside the merged component
+ * are dropped from its lists.
+ * Parameters:
+ *      members: Components to merge
+ *
+ * Return: Component representing the merged set
+ */
+int IncrementalSCC::mergeAll(const vector<int>& members){
+	// the largest member keeps its lists, the others are appended
+	int root = members[0];
+	for (int comp : members){
+		if (outEdges[comp].size() + inEdges[comp].size() >
+		                          outEdges[root].size() + inEdges[root].size())
+			root = comp;
+	}
+	for (int comp : members){
+		if (comp == root)
+			continue;
+		parent[comp] = root;
+		setSize[root] += setSize[comp];
+		outEdges[root].insert(outEdges[root].end(), outEdges[comp].begin(),
+		                                            outEdges[comp].end());
+		inEdges[root].insert(inEdges[root].end(), inEdges[comp].begin(),
+		                                          inEdges[comp].end());
+		vector<int>().swap(outEdges[comp]);
+		vector<int>().swap(inEdges[comp]);
+		numComponents--;
+	}
+
+	// drop edges that now start and end inside the component
+	for (vector<int>* edges : { &outEdges[root], &inEdges[root] }){
+		edges->erase(remove_if(edges->begin(), edges->end(),
+		             [this, root](int user){ return find(user) == root; }),
+		             edges->end());
+	}
+	return root;
+}
+
+/**
+ * Adds the edge retweeter -> original and updates the components
+ * Parameters:
+ *      from: Id of the user who retweeted
+ *      to: Id of the user who was retweeted
+ *
+ */
+void IncrementalSCC::addEdge(int from, int to){
+	int tail = node(from);
+	int head = node(to);
+	numEdges++;
+
+	int tailComp = find(tail);
+	int headComp = find(head);
+	if (tailComp == headComp)
+		return;
+
+	outEdges[tailComp].push_back(head);
+	inEdges[headComp].push_back(tail);
+
+	// the edge agrees with the topological order
+	if (order[tailComp] < order[headComp])
+		return;
+
+	// every path from head back to tail lies between their positions
+	vector<int> forward;
+	vector<int> backward;
+	search(headComp, true, order[tailComp], forward);
+	bool cycle = (visited[tailComp] == stamp);
+	search(tailComp, false, order[headComp], backward);
+	int backwardStamp = stamp;
+
+	// the positions of everything found are handed out again in order
+	vector<int> slots;
+	for (int comp : forward)
+		slots.push_back(order[comp]);
+	for (int comp : backward)
+		slots.push_back(order[comp]);
+	sort(slots.begin(), slots.end());
+	slots.erase(unique(slots.begin(), slots.end()), slots.end());
+
+	auto byOrder = [this](int lhs, int rhs){ return order[lhs] < order[rhs]; };
+	vector<int> before;    // reaches tail only, takes the lowest positions
+	vector<int> after;     // reached from head only, takes the highest
+	int merged = -1;       // the new component closed by the edge
+
+	if (cycle){
+		// components found by both searches lie on a cycle with the edge
+		vector<int> members;
+		for (int comp : forward){
+			if (visited[comp] == backwardStamp)
+				members.push_back(comp);
+			else
+				after.push_back(comp);
+		}
+		stamp++;
+		for (int comp : members)
+			visited[comp] = stamp;
+		for (int comp : backward){
+			if (visited[comp] != stamp)
+				before.push_back(comp);
+		}
+		merged = mergeAll(members);
+	}
+	else{
+		before = backward;
+		after = forward;
+	}
+
+	// before only moves down and after only moves up, so the edges to and
+	// from components outside the searches keep agreeing with the order
+	sort(before.begin(), before.end(), byOrder);
+	sort(after.begin(), after.end(), byOrder);
+	for (size_t k = 0; k < before.size(); k++)
+		order[before[k]] = slots[k];
+	if (merged != -1)
+		order[merged] = slots[before.size()];
+	for (size_t k = 0; k < after.size(); k++)
+		order[after[k]] = slots[slots.size() - after.size() + k];
+}
+
+/**
+ * Writes one line of statistics: edges, users, components and the sizes
+ * of the largest components
+ * Parameters:
+ *      out: Stream to write to
+ *      largest: Number of component sizes to list
+ *
+ */
+void IncrementalSCC::report(ostream& out, int largest){
+	vector<int> sizes;
+	for (int index = 0; index < (int)parent.size(); index++){
+		if (parent[index] == index)
+			sizes.push_back(setSize[index]);
+	}
+	int count = min(largest, (int)sizes.size());
+	partial_sort(sizes.begin(), sizes.begin() + count, sizes.end(),
+	             greater<int>());
+
+	out << "edges\t" << numEdges << "\tusers\t" << userID.size()
+	    << "\tcomponents\t" << numComponents << "\tlargest\t";
+	for (int k = 0; k < count; k++)
+		out << (k ? "," : "") << sizes[k];
+	out << "\n";
+}
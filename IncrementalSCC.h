@@ -0,0 +1,110 @@
+/*
+ * IncrementalSCC.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 2, 2016
+ *
+ * Defines the IncrementalSCC class used by the streaming mode of the
+ * extension. Retweet edges are added one at a time and the strongly
+ * connected components are kept up to date without recomputing them.
+ */
+
+#ifndef INCREMENTALSCC_H
+#define INCREMENTALSCC_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * Maintains the strongly connected components of a growing directed graph.
+ * Components are sets of a union-find; the condensation DAG between them
+ * is kept in a topological order (Pearce-Kelly). A new edge that agrees
+ * with the order costs O(1). One that goes against it searches only the
+ * components ordered between its two ends: if the search closes a cycle,
+ * every component on the cycle is merged into one, otherwise the
+ * components found are moved so the order holds again.
+ */
+class IncrementalSCC {
+	private:
+		unordered_map<int, int> indexOf;   // user id to dense index
+		vector<int> userID;                // dense index to user id
+		vector<int> parent;                // union-find over users
+		vector<int> setSize;               // users in a component
+		vector<int> order;                 // topological position
+		vector<vector<int>> outEdges;      // heads of edges leaving a set
+		vector<vector<int>> inEdges;       // tails of edges entering a set
+		vector<int> visited;               // search stamp of a component
+		int stamp;                         // current search stamp
+		int nextOrder;                     // position for new components
+		int numComponents;                 // number of components
+		long numEdges;                     // edges added so far
+
+        /**
+         * Dense index of a user, adding the user if it is new
+         * Parameters:
+         *      id: Id of the user
+         *
+         * Return: Dense index of the user
+         */
+		int node(int id);
+
+        /**
+         * Collects the components reachable from start along out edges
+         * (or in edges) whose position lies within a bound
+         * Parameters:
+         *      start: Component to start from
+         *      forward: Follow out edges with position <= bound, or in
+         *               edges with position >= bound
+         *      bound: Position limit of the search
+         *      found: Filled with the components reached, start included
+         *
+         */
+		void search(int start, bool forward, int bound, vector<int>& found);
+
+        /**
+         * Merges a set of components into one
+         * Parameters:
+         *      members: Components to merge
+         *
+         * Return: Component representing the merged set
+         */
+		int mergeAll(const vector<int>& members);
+
+	public:
+        /**
+         * Default constructor, empty graph
+         */
+		IncrementalSCC(void);
+
+        /**
+         * Component a user belongs to
+         * Parameters:
+         *      index: Dense index of the user
+         *
+         * Return: Representative of the component
+         */
+		int find(int index);
+
+        /**
+         * Adds the edge retweeter -> original and updates the components
+         * Parameters:
+         *      from: Id of the user who retweeted
+         *      to: Id of the user who was retweeted
+         *
+         */
+		void addEdge(int from, int to);
+
+        /**
+         * Writes one line of statistics: edges, users, components and the
+         * sizes of the largest components
+         * Parameters:
+         *      out: Stream to write to
+         *      largest: Number of component sizes to list
+         *
+         */
+		void report(ostream& out, int largest);
+};
+
+#endif // INCREMENTALSCC_H
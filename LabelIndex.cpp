@@ -0,0 +1,367 @@
+/*
+ * LabelIndex.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 7, 2016
+ *
+ * Implements the pruned landmark labeling declared in LabelIndex.h.
+ */
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Adjacency.h"
+#include "LabelIndex.h"
+
+using namespace std;
+
+#define INDEX_MAGIC 0x4c4c5052     // "RPLL"
+#define INDEX_VERSION 2
+
+/**
+ * Default constructor, an empty index
+ */
+LabelIndex::LabelIndex(void) : actorCount(0), fingerprint(0) {}
+
+/**
+ * Number of actors labeled
+ *
+ * Return: Number of actors, 0 before the index is built
+ */
+int LabelIndex::size() const {
+	return actorCount;
+}
+
+/**
+ * Total number of label entries
+ *
+ * Return: Sum of the label sizes of every actor
+ */
+long long LabelIndex::entries() const {
+	return hubs.size();
+}
+
+/**
+ * Mixes bytes into a 64 bit FNV-1a hash
+ * Parameters:
+ *      hash: Hash so far
+ *      data: Bytes to mix in
+ *      length: Number of bytes
+ *
+ * Return: Updated hash
+ */
+static uint64_t mixHash(uint64_t hash, const void * data, size_t length){
+	const unsigned char * bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < length; i++){
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * Hash of the graph in index order: the name of every actor and each of
+ * its edges, co-star, movie and year, then the number of edges. Reordering the
+ * actors, loading other data or other casts of the same actors changes it,
+ * so a stale index is never used.
+ * Parameters:
+ *      graph: Graph to hash
+ *
+ * Return: 64 bit FNV-1a hash of the names and edges
+ */
+uint64_t LabelIndex::fingerprintOf(ActorGraph& graph){
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	int64_t edges = 0;
+	int count = graph.size();
+	for (int actor = 0; actor < count; actor++){
+		const char * name = graph.nameOf(actor);
+		hash = mixHash(hash, name, strlen(name) + 1);
+		for (const ActorEdge& edge : graph.edgesOf(actor)){
+			int32_t link[3] = { edge.actor, edge.movie, edge.year };
+			hash = mixHash(hash, link, sizeof(link));
+			edges++;
+		}
+	}
+	return mixHash(hash, &edges, sizeof(edges));
+}
+
+/**
+ * Builds the labels of every actor. Actors become hubs from the highest
+ * degree down; the search from a hub skips actors that were hubs already
+ * and does not expand an actor whose distance the labels so far give.
+ * Parameters:
+ *      graph: Graph to label
+ *
+ */
+void LabelIndex::build(ActorGraph& graph){
+	Adjacency adjacency;
+	graph.buildAdjacency(adjacency, false);
+	actorCount = adjacency.size();
+	fingerprint = fingerprintOf(graph);
+
+	order.resize(actorCount);
+	for (int actor = 0; actor < actorCount; actor++)
+		order[actor] = actor;
+	stable_sort(order.begin(), order.end(), [&](int lhs, int rhs){
+		return adjacency.degree(lhs) > adjacency.degree(rhs);
+	});
+
+	// labels grow one hub at a time, hub ranks only increase
+	vector<vector<int>> labelHubs(actorCount);
+	vector<vector<int>> labelDists(actorCount);
+	vector<vector<int>> labelParents(actorCount);
+
+	vector<int> hubDist(actorCount, INT_MAX); // label of the hub, by rank
+	vector<int> level(actorCount, INT_MAX);   // hops from the hub
+	vector<int> parent(actorCount, -1);       // next actor towards the hub
+	vector<bool> labeled(actorCount, false);  // was a hub already
+	vector<int> queue;
+	queue.reserve(actorCount);
+
+	for (int rank = 0; rank < actorCount; rank++){
+		int hub = order[rank];
+		vector<int>& ownHubs = labelHubs[hub];
+		for (int i = 0; i < (int)ownHubs.size(); i++)
+			hubDist[ownHubs[i]] = labelDists[hub][i];
+
+		queue.clear();
+		queue.push_back(hub);
+		level[hub] = 0;
+		parent[hub] = -1;
+		for (size_t head = 0; head < queue.size(); head++){
+			int actor = queue[head];
+			int hops = level[actor];
+
+			// pruned if an earlier hub already gives the distance
+			vector<int>& actorHubs = labelHubs[actor];
+			vector<int>& actorDists = labelDists[actor];
+			bool covered = false;
+			for (int i = 0; i < (int)actorHubs.size() && !covered; i++){
+				int through = hubDist[actorHubs[i]];
+				covered = through != INT_MAX &&
+				          through + actorDists[i] <= hops;
+			}
+			if (covered)
+				continue;
+
+			actorHubs.push_back(rank);
+			actorDists.push_back(hops);
+			labelParents[actor].push_back(parent[actor]);
+
+			for (int e = adjacency.offsets[actor];
+			                           e < adjacency.offsets[actor + 1]; e++){
+				int costar = adjacency.targets[e];
+				if (labeled[costar] || level[costar] != INT_MAX)
+					continue;
+				level[costar] = hops + 1;
+				parent[costar] = actor;
+				queue.push_back(costar);
+			}
+		}
+
+		for (int actor : queue)
+			level[actor] = INT_MAX;
+		for (int i = 0; i < (int)ownHubs.size(); i++)
+			hubDist[ownHubs[i]] = INT_MAX;
+		labeled[hub] = true;
+	}
+
+	// flatten into the parallel arrays
+	offsets.assign(actorCount + 1, 0);
+	for (int actor = 0; actor < actorCount; actor++)
+		offsets[actor + 1] = offsets[actor] + labelHubs[actor].size();
+	hubs.resize(offsets[actorCount]);
+	dists.resize(offsets[actorCount]);
+	parents.resize(offsets[actorCount]);
+	for (int actor = 0; actor < actorCount; actor++){
+		copy(labelHubs[actor].begin(), labelHubs[actor].end(),
+		                                      hubs.begin() + offsets[actor]);
+		copy(labelDists[actor].begin(), labelDists[actor].end(),
+		                                      dists.begin() + offsets[actor]);
+		copy(labelParents[actor].begin(), labelParents[actor].end(),
+		                                    parents.begin() + offsets[actor]);
+	}
+}
+
+/**
+ * Finds the hub on a shortest path between two actors by merging their
+ * labels, both sorted by hub rank
+ * Parameters:
+ *      fromActor: index of the first actor
+ *      toActor: index of the second actor
+ *      distance: set to the hop distance, INT_MAX if not connected
+ *
+ * Return: Rank of the hub, -1 if the actors are not connected
+ */
+int LabelIndex::meet(int fromActor, int toActor, int& distance) const {
+	distance = INT_MAX;
+	if (fromActor < 0 || toActor < 0 ||
+	                        fromActor >= actorCount || toActor >= actorCount)
+		return -1;
+
+	int64_t i = offsets[fromActor];
+	int64_t iEnd = offsets[fromActor + 1];
+	int64_t j = offsets[toActor];
+	int64_t jEnd = offsets[toActor + 1];
+	int best = -1;
+	while (i < iEnd && j < jEnd){
+		if (hubs[i] < hubs[j])
+			i++;
+		else if (hubs[i] > hubs[j])
+			j++;
+		else{
+			if (dists[i] + dists[j] < distance){
+				distance = dists[i] + dists[j];
+				best = hubs[i];
+			}
+			i++;
+			j++;
+		}
+	}
+	return best;
+}
+
+/**
+ * Hop distance between two actors
+ * Parameters:
+ *      fromActor: index of the first actor
+ *      toActor: index of the second actor
+ *
+ * Return: Number of movies linking the actors, INT_MAX if they are not
+ *         connected
+ */
+int LabelIndex::distance(int fromActor, int toActor) const {
+	int distance;
+	meet(fromActor, toActor, distance);
+	return distance;
+}
+
+/**
+ * Appends the actors from an actor up to, not including, a hub. Every
+ * actor on the way was expanded by the search from the hub, so each of
+ * them lists the hub too.
+ * Parameters:
+ *      actor: index of the actor to start at
+ *      hub: rank of a hub in the actor's label
+ *      path: vector the actors are appended to
+ *
+ */
+void LabelIndex::climb(int actor, int hub, vector<int>& path) const {
+	while (actor != order[hub]){
+		path.push_back(actor);
+		const int * begin = hubs.data() + offsets[actor];
+		const int * end = hubs.data() + offsets[actor + 1];
+		actor = parents[lower_bound(begin, end, hub) - hubs.data()];
+	}
+}
+
+/**
+ * Recovers a shortest path between two actors: from the first actor up to
+ * the hub they meet at, then down to the second actor
+ * Parameters:
+ *      fromActor: index of Actor the path starts at
+ *      toActor: index of Actor the path ends at
+ *      path: set to the indices of the actors on the path
+ *
+ * Return: true if the actors are connected, false otherwise
+ */
+bool LabelIndex::path(int fromActor, int toActor, vector<int>& path) const {
+	int distance;
+	int hub = meet(fromActor, toActor, distance);
+	path.clear();
+	if (hub < 0)
+		return false;
+
+	climb(fromActor, hub, path);
+	path.push_back(order[hub]);
+	size_t middle = path.size();
+	climb(toActor, hub, path);
+	reverse(path.begin() + middle, path.end());
+	return true;
+}
+
+/**
+ * Reads an index written by save. An index of other data or of another
+ * ordering of the actors is not used.
+ * Parameters:
+ *      filename: File to read
+ *      graph: Graph the index has to belong to
+ *
+ * Return: true if the file held an index of this graph, false otherwise
+ */
+bool LabelIndex::load(const char * filename, ActorGraph& graph){
+	FILE * file = fopen(filename, "rb");
+	if (!file)
+		return false;
+	uint32_t header[2];
+	int64_t sizes[2];
+	uint64_t hash;
+	bool valid = fread(header, sizeof(header), 1, file) == 1 &&
+	             header[0] == INDEX_MAGIC && header[1] == INDEX_VERSION &&
+	             fread(sizes, sizeof(sizes), 1, file) == 1 &&
+	             fread(&hash, sizeof(hash), 1, file) == 1 &&
+	             sizes[0] == graph.size() && sizes[1] >= 0 &&
+	             hash == fingerprintOf(graph);
+	if (valid){
+		actorCount = sizes[0];
+		fingerprint = hash;
+		order.resize(sizes[0]);
+		offsets.resize(sizes[0] + 1);
+		hubs.resize(sizes[1]);
+		dists.resize(sizes[1]);
+		parents.resize(sizes[1]);
+		valid = fread(order.data(), sizeof(int), order.size(), file)
+		                                                  == order.size() &&
+		        fread(offsets.data(), sizeof(int64_t), offsets.size(), file)
+		                                                  == offsets.size() &&
+		        fread(hubs.data(), sizeof(int), hubs.size(), file)
+		                                                  == hubs.size() &&
+		        fread(dists.data(), sizeof(int), dists.size(), file)
+		                                                  == dists.size() &&
+		        fread(parents.data(), sizeof(int), parents.size(), file)
+		                                                  == parents.size() &&
+		        offsets.front() == 0 && offsets.back() == sizes[1];
+	}
+	fclose(file);
+	if (!valid){
+		actorCount = 0;
+		order.clear();
+		offsets.clear();
+		hubs.clear();
+		dists.clear();
+		parents.clear();
+	}
+	return valid;
+}
+
+/**
+ * Writes the index as a binary file: magic, version, number of actors,
+ * number of label entries, the graph fingerprint, then order, offsets,
+ * hubs, dists and parents as raw arrays
+ * Parameters:
+ *      filename: File to write
+ *
+ * Return: true if the file was written, false otherwise
+ */
+bool LabelIndex::save(const char * filename) const {
+	FILE * file = fopen(filename, "wb");
+	if (!file)
+		return false;
+	uint32_t header[2] = { INDEX_MAGIC, INDEX_VERSION };
+	int64_t sizes[2] = { (int64_t)actorCount, (int64_t)hubs.size() };
+	bool written = fwrite(header, sizeof(header), 1, file) == 1 &&
+	               fwrite(sizes, sizeof(sizes), 1, file) == 1 &&
+	               fwrite(&fingerprint, sizeof(fingerprint), 1, file) == 1 &&
+	               fwrite(order.data(), sizeof(int), order.size(), file)
+	                                                     == order.size() &&
+	               fwrite(offsets.data(), sizeof(int64_t), offsets.size(),
+	                                             file) == offsets.size() &&
+	               fwrite(hubs.data(), sizeof(int), hubs.size(), file)
+	                                                     == hubs.size() &&
+	               fwrite(dists.data(), sizeof(int), dists.size(), file)
+	                                                     == dists.size() &&
+	               fwrite(parents.data(), sizeof(int), parents.size(), file)
+	                                                     == parents.size();
+	return fclose(file) == 0 && written;
+}
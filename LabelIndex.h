@@ -0,0 +1,143 @@
+/*
+ * LabelIndex.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 7, 2016
+ *
+ * Defines the LabelIndex class, a pruned landmark labeling of the unweighted
+ * actor graph. Every actor keeps a label: a list of hub actors with the hop
+ * distance to each. The hubs are visited from the highest degree down and a
+ * breadth first search from a hub stops wherever the labels built so far
+ * already give the right distance, so the labels stay short. Any shortest
+ * path passes through a hub both endpoints list, and a distance query is a
+ * merge of two sorted labels with no traversal of the graph at all.
+ */
+
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "ActorGraph.h"
+
+using namespace std;
+
+/**
+ * 2-hop distance labels of every actor. The label of actor a is the range
+ * [offsets[a], offsets[a + 1]) of the parallel arrays hubs, dists and
+ * parents, sorted by hub rank. parents holds the next actor on a shortest
+ * path from a to the hub, which is what lets a query recover the path.
+ */
+class LabelIndex {
+	private:
+		int actorCount;                  // number of actors labeled
+		uint64_t fingerprint;            // names and edges of the graph
+		vector<int> order;               // actor of each hub rank
+		vector<int64_t> offsets;         // start of each actor's label
+		vector<int> hubs;                // hub rank of each label entry
+		vector<int> dists;               // hops from the actor to the hub
+		vector<int> parents;             // next actor towards the hub
+
+        /**
+         * Hash of the names and edges of every actor in index order, used
+         * to tell whether a saved index belongs to a graph
+         * Parameters:
+         *      graph: Graph to hash
+         *
+         * Return: 64 bit FNV-1a hash of the names and edges
+         */
+		static uint64_t fingerprintOf(ActorGraph& graph);
+
+        /**
+         * Finds the hub on a shortest path between two actors
+         * Parameters:
+         *      fromActor: index of the first actor
+         *      toActor: index of the second actor
+         *      distance: set to the hop distance, INT_MAX if not connected
+         *
+         * Return: Rank of the hub, -1 if the actors are not connected
+         */
+		int meet(int fromActor, int toActor, int& distance) const;
+
+        /**
+         * Appends the actors from an actor up to, not including, a hub
+         * Parameters:
+         *      actor: index of the actor to start at
+         *      hub: rank of a hub in the actor's label
+         *      path: vector the actors are appended to
+         *
+         */
+		void climb(int actor, int hub, vector<int>& path) const;
+
+	public:
+        /**
+         * Default constructor, an empty index
+         */
+		LabelIndex(void);
+
+        /**
+         * Builds the labels of every actor by pruned breadth first
+         * searches from each actor, highest degree first
+         * Parameters:
+         *      graph: Graph to label
+         *
+         */
+		void build(ActorGraph& graph);
+
+        /**
+         * Reads an index written by save
+         * Parameters:
+         *      filename: File to read
+         *      graph: Graph the index has to belong to
+         *
+         * Return: true if the file held an index of this graph, false
+         *         otherwise
+         */
+		bool load(const char * filename, ActorGraph& graph);
+
+        /**
+         * Writes the index to a binary file
+         * Parameters:
+         *      filename: File to write
+         *
+         * Return: true if the file was written, false otherwise
+         */
+		bool save(const char * filename) const;
+
+        /**
+         * Number of actors labeled
+         *
+         * Return: Number of actors, 0 before the index is built
+         */
+		int size() const;
+
+        /**
+         * Total number of label entries
+         *
+         * Return: Sum of the label sizes of every actor
+         */
+		long long entries() const;
+
+        /**
+         * Hop distance between two actors
+         * Parameters:
+         *      fromActor: index of the first actor
+         *      toActor: index of the second actor
+         *
+         * Return: Number of movies linking the actors, INT_MAX if they are
+         *         not connected
+         */
+		int distance(int fromActor, int toActor) const;
+
+        /**
+         * Recovers a shortest path between two actors
+         * Parameters:
+         *      fromActor: index of Actor the path starts at
+         *      toActor: index of Actor the path ends at
+         *      path: set to the indices of the actors on the path
+         *
+         * Return: true if the actors are connected, false otherwise
+         */
+		bool path(int fromActor, int toActor, vector<int>& path) const;
+};
+
+#endif // LABELINDEX_H
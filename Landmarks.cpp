@@ -0,0 +1,146 @@
+/*
+ * Landmarks.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   November 28, 2016
+ *
+ * Implements landmark selection and the landmark distance table used by the
+ * ALT search in ActorGraph::AStar.
+ */
+#include <vector>
+#include <climits>
+#include "Landmarks.h"
+
+using namespace std;
+
+/**
+ * Default constructor, no landmarks
+ */
+Landmarks::Landmarks(void) : actorCount(0) {}
+
+/**
+ * Number of landmarks
+ *
+ * Return: Number of landmarks that were built
+ */
+int Landmarks::size() const {
+	return landmarks.size();
+}
+
+/**
+ * Runs Dijkstra from one landmark and stores its distance column
+ * Parameters:
+ *      graph: Graph the landmarks belong to
+ *      k: position of the landmark to fill in
+ *
+ */
+void Landmarks::fillColumn(ActorGraph& graph, int k){
+	int count = landmarks.size();
+	graph.Dijkstra(landmarks[k], -1);
+
+	// a column that does not fit is zeroed rather than clamped, clamping
+	// would make the bound inconsistent
+	bool fits = true;
+	for (int actor = 0; actor < actorCount; actor++){
+		int dist = graph.distanceTo(actor);
+		if (dist != INT_MAX && dist >= LANDMARK_UNREACHED)
+			fits = false;
+	}
+
+	for (int actor = 0; actor < actorCount; actor++){
+		int dist = graph.distanceTo(actor);
+		unsigned short value;
+		if (dist == INT_MAX)
+			value = LANDMARK_UNREACHED;
+		else if (!fits)
+			value = 0;
+		else
+			value = dist;
+		distances[(size_t)actor * count + k] = value;
+	}
+}
+
+/**
+ * Picks landmarks by farthest point selection: each new landmark is the
+ * actor farthest from all the landmarks chosen so far.
+ * Parameters:
+ *      graph: Graph to pick the landmarks from
+ *      count: Number of landmarks to pick
+ *
+ */
+void Landmarks::build(ActorGraph& graph, int count){
+	actorCount = graph.size();
+	landmarks.clear();
+	distances.clear();
+	if (actorCount == 0 || count <= 0)
+		return;
+
+	// the actor with the most edges sits in the giant component, the first
+	// landmark is the actor farthest away from it
+	int hub = 0;
+	for (int actor = 1; actor < actorCount; actor++){
+		if (graph.degreeOf(actor) > graph.degreeOf(hub))
+			hub = actor;
+	}
+	graph.Dijkstra(hub, -1);
+	vector<int> nearest(actorCount);  // distance to the closest landmark
+	for (int actor = 0; actor < actorCount; actor++)
+		nearest[actor] = graph.distanceTo(actor);
+
+	for (int k = 0; k < count; k++){
+		// the next landmark is the reached actor farthest from the others
+		int farthest = -1;
+		for (int actor = 0; actor < actorCount; actor++){
+			if (nearest[actor] == INT_MAX || nearest[actor] == 0)
+				continue;
+			if (farthest == -1 || nearest[actor] > nearest[farthest])
+				farthest = actor;
+		}
+		if (farthest == -1)
+			break;
+
+		landmarks.push_back(farthest);
+		graph.Dijkstra(farthest, -1);
+		for (int actor = 0; actor < actorCount; actor++){
+			if (graph.distanceTo(actor) < nearest[actor])
+				nearest[actor] = graph.distanceTo(actor);
+		}
+	}
+
+	distances.assign((size_t)actorCount * landmarks.size(), 0);
+	refresh(graph);
+}
+
+/**
+ * Recomputes the distance columns of all the landmarks, needed once edges
+ * have been added to the graph
+ * Parameters:
+ *      graph: Graph the landmarks belong to
+ *
+ */
+void Landmarks::refresh(ActorGraph& graph){
+	int size = graph.size();
+	if (size != actorCount){
+		distances.resize((size_t)size * landmarks.size(), LANDMARK_UNREACHED);
+		actorCount = size;
+	}
+	for (int k = 0; k < (int)landmarks.size(); k++)
+		fillColumn(graph, k);
+}
+
+/**
+ * Recomputes the distance column of a single landmark. Actors added since
+ * the last build are missing from every column, so if the graph grew all
+ * the columns are recomputed instead; otherwise the new actors would stay
+ * unreached by the other landmarks and look cut off from the rest.
+ * Parameters:
+ *      graph: Graph the landmarks belong to
+ *      k: position of the landmark to refresh
+ *
+ */
+void Landmarks::refresh(ActorGraph& graph, int k){
+	if (graph.size() != actorCount){
+		refresh(graph);
+		return;
+	}
+	fillColumn(graph, k);
+}
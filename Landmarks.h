@@ -0,0 +1,116 @@
+/*
+ * Landmarks.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    November 28, 2016
+ *
+ * Defines the Landmarks class used for ALT (A*, landmarks and triangle
+ * inequality) searches. A few well spread actors are picked as landmarks and
+ * the weighted distance from each of them to every actor is stored. By the
+ * triangle inequality |d(L,t) - d(L,v)| never overestimates d(v,t), which
+ * gives ActorGraph::AStar an admissible and consistent lower bound.
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <vector>
+#include <climits>
+#include "ActorGraph.h"
+
+using namespace std;
+
+/**
+ * Landmark distance table. Distances are kept as 16 bit values, one row of
+ * K values per actor so a lower bound reads two short contiguous rows. A
+ * landmark whose distances do not fit in 16 bits is stored as all zeros,
+ * which keeps the bound consistent at the cost of that landmark.
+ */
+class Landmarks {
+	private:
+		vector<int> landmarks;           // actor index of every landmark
+		vector<unsigned short> distances;// distances[actor * K + landmark]
+		int actorCount;                  // number of actors in each column
+
+        /**
+         * Runs Dijkstra from one landmark and stores its distance column
+         * Parameters:
+         *      graph: Graph the landmarks belong to
+         *      k: position of the landmark to fill in
+         *
+         */
+		void fillColumn(ActorGraph& graph, int k);
+
+	public:
+		static const int LANDMARK_UNREACHED = 0xffff;  // not connected
+
+        /**
+         * Default constructor, no landmarks
+         */
+		Landmarks(void);
+
+        /**
+         * Picks landmarks by farthest point selection: each new landmark is
+         * the actor farthest from all the landmarks chosen so far.
+         * Parameters:
+         *      graph: Graph to pick the landmarks from
+         *      count: Number of landmarks to pick
+         *
+         */
+		void build(ActorGraph& graph, int count);
+
+        /**
+         * Recomputes the distance columns of all the landmarks, needed once
+         * edges have been added to the graph
+         * Parameters:
+         *      graph: Graph the landmarks belong to
+         *
+         */
+		void refresh(ActorGraph& graph);
+
+        /**
+         * Recomputes the distance column of a single landmark, or every
+         * column if actors were added to the graph since the last build
+         * Parameters:
+         *      graph: Graph the landmarks belong to
+         *      k: position of the landmark to refresh
+         *
+         */
+		void refresh(ActorGraph& graph, int k);
+
+        /**
+         * Number of landmarks
+         *
+         * Return: Number of landmarks that were built
+         */
+		int size() const;
+
+        /**
+         * Lower bound on the weighted distance between two actors
+         * Parameters:
+         *      actor: index of the actor the search is at
+         *      target: index of the actor the search is going to
+         *
+         * Return: Lower bound, INT_MAX if actor cannot reach target
+         */
+		int lowerBound(int actor, int target) const {
+			int count = landmarks.size();
+			const unsigned short * from = distances.data() + (size_t)actor * count;
+			const unsigned short * to = distances.data() + (size_t)target * count;
+			int bound = 0;
+			for (int k = 0; k < count; k++) {
+				int lhs = from[k];
+				int rhs = to[k];
+				// a landmark reaches exactly one of the two actors
+				if ((lhs == LANDMARK_UNREACHED) != (rhs == LANDMARK_UNREACHED))
+					return INT_MAX;
+				if (lhs == LANDMARK_UNREACHED)
+					continue;
+				int diff = (lhs > rhs) ? lhs - rhs : rhs - lhs;
+				if (diff > bound)
+					bound = diff;
+			}
+			return bound;
+		}
+};
+
+#endif // LANDMARKS_H
@@ -0,0 +1,248 @@
+/*
+ * OutputWriter.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 6, 2016
+ *
+ * Implements the buffered output declared in OutputWriter.h.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <new>
+#include <unistd.h>
+#include "OutputWriter.h"
+
+using namespace std;
+
+// buffers of one writer: the one being filled plus the ones queued
+#define WRITER_BUFFERS 4
+
+/**
+ * Constructor
+ * Parameters:
+ *      size: Initial capacity in bytes
+ */
+OutputBuffer::OutputBuffer(size_t size) : length(0), capacity(max(size,
+                                                               (size_t)1)) {
+	data = (char *)malloc(capacity);
+	if (!data)
+		throw bad_alloc();
+}
+
+/**
+ * Destructor
+ */
+OutputBuffer::~OutputBuffer(){
+	free(data);
+}
+
+/**
+ * Makes room for more bytes by doubling the capacity
+ * Parameters:
+ *      needed: Bytes about to be appended
+ *
+ */
+void OutputBuffer::overflow(size_t needed){
+	size_t size = max(capacity * 2, length + needed);
+	char * grown = (char *)realloc(data, size);
+	if (!grown)
+		throw bad_alloc();
+	data = grown;
+	capacity = size;
+}
+
+/**
+ * Appends the decimal form of an integer. Digits are produced two at a
+ * time from a table, last digit first.
+ * Parameters:
+ *      value: Integer to append
+ *
+ */
+void OutputBuffer::appendInt(long long value){
+	static const char pairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233"
+		"34353637383940414243444546474849505152535455565758596061626364656667"
+		"6869707172737475767778798081828384858687888990919293949596979899";
+	char digits[20];
+	char * end = digits + sizeof(digits);
+	char * curr = end;
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value
+	                                         : (unsigned long long)value;
+	while (magnitude >= 100){
+		int pair = (magnitude % 100) * 2;
+		magnitude /= 100;
+		*--curr = pairs[pair + 1];
+		*--curr = pairs[pair];
+	}
+	if (magnitude >= 10){
+		*--curr = pairs[magnitude * 2 + 1];
+		*--curr = pairs[magnitude * 2];
+	}
+	else
+		*--curr = '0' + magnitude;
+	if (value < 0)
+		*--curr = '-';
+	append(curr, end - curr);
+}
+
+/**
+ * Constructor, truncates or creates the file and starts the thread
+ * Parameters:
+ *      out_filename: File to write
+ *      size: Capacity of each buffer in bytes
+ */
+OutputWriter::OutputWriter(const char * out_filename, size_t size) :
+	OutputBuffer(size), bufferSize(capacity), buffersLeft(WRITER_BUFFERS - 1),
+	failed(false), closing(false), nextSequence(0) {
+	fd = open(out_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	failed = (fd < 0);
+	worker = thread(&OutputWriter::writeLoop, this);
+}
+
+/**
+ * Destructor, writes everything still buffered
+ */
+OutputWriter::~OutputWriter(){
+	close();
+	for (char * buffer : spare)
+		free(buffer);
+}
+
+/**
+ * Whether the file is open and every write so far succeeded
+ */
+bool OutputWriter::good(){
+	lock_guard<mutex> guard(lock);
+	return !failed;
+}
+
+/**
+ * Queues the current buffer for the thread and takes a spare one, waiting
+ * for the thread to free one when every buffer is in use. A request larger
+ * than a buffer gets a buffer of its own size.
+ * Parameters:
+ *      needed: Bytes about to be appended
+ *
+ */
+void OutputWriter::overflow(size_t needed){
+	unique_lock<mutex> guard(lock);
+	if (length)
+		full.push_back(make_pair(data, length));
+	else
+		spare.push_back(data);
+	ready.notify_all();
+
+	if (spare.empty() && buffersLeft == 0)
+		ready.wait(guard, [this](){ return !spare.empty(); });
+	if (!spare.empty()){
+		data = spare.back();
+		spare.pop_back();
+	}
+	else{
+		data = (char *)malloc(bufferSize);
+		if (!data)
+			throw bad_alloc();
+		buffersLeft--;
+	}
+	capacity = bufferSize;
+	length = 0;
+	guard.unlock();
+
+	if (needed > capacity){
+		char * grown = (char *)realloc(data, needed);
+		if (!grown)
+			throw bad_alloc();
+		data = grown;
+		capacity = needed;
+	}
+}
+
+/**
+ * Body of the background thread: writes queued buffers in order and hands
+ * them back as spares, until close has been called and the queue is empty
+ */
+void OutputWriter::writeLoop(){
+	unique_lock<mutex> guard(lock);
+	while (true){
+		ready.wait(guard, [this](){ return closing || !full.empty(); });
+		if (full.empty())
+			return;
+		pair<char *, size_t> buffer = full.front();
+		full.pop_front();
+		guard.unlock();
+
+		bool ok = fd >= 0;
+		size_t written = 0;
+		while (ok && written < buffer.second){
+			ssize_t count = write(fd, buffer.first + written,
+			                                      buffer.second - written);
+			if (count < 0 && errno == EINTR)
+				continue;
+			ok = count > 0;
+			if (ok)
+				written += count;
+		}
+
+		guard.lock();
+		failed = failed || !ok;
+		spare.push_back(buffer.first);
+		ready.notify_all();
+	}
+}
+
+/**
+ * Appends the result of one query once every earlier query has been
+ * appended. Results that arrive early wait in pending.
+ * Parameters:
+ *      sequence: Number of the query, counting from 0
+ *      result: Formatted result of the query
+ *
+ */
+void OutputWriter::commit(long sequence, const OutputBuffer& result){
+	lock_guard<mutex> guard(commitLock);
+	if (sequence != nextSequence){
+		pending[sequence] = string(result.bytes(), result.size());
+		return;
+	}
+	append(result.bytes(), result.size());
+	nextSequence++;
+
+	// results that were waiting for this one follow it
+	for (auto it = pending.begin();
+	              it != pending.end() && it->first == nextSequence;
+	              it = pending.erase(it)){
+		append(it->second.data(), it->second.size());
+		nextSequence++;
+	}
+}
+
+/**
+ * Writes everything still buffered and closes the file
+ *
+ * Return: true if every write succeeded, false otherwise
+ */
+bool OutputWriter::close(){
+	if (!worker.joinable())
+		return good();
+
+	{
+		lock_guard<mutex> guard(lock);
+		if (length)
+			full.push_back(make_pair(data, length));
+		else
+			spare.push_back(data);
+		data = NULL;
+		length = 0;
+		capacity = 0;
+		closing = true;
+		ready.notify_all();
+	}
+	worker.join();
+
+	lock_guard<mutex> guard(lock);
+	if (fd >= 0 && ::close(fd) < 0)
+		failed = true;
+	fd = -1;
+	return !failed;
+}
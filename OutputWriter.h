@@ -0,0 +1,205 @@
+/*
+ * OutputWriter.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 6, 2016
+ *
+ * Defines the OutputBuffer and OutputWriter classes used to write query
+ * results. Text is formatted straight into a large buffer with a hand
+ * written integer conversion and no locale; the writer hands full buffers
+ * to a background thread that writes them to the file, so formatting and
+ * disk writes overlap. The bytes are the same ofstream would write.
+ */
+
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Growable character buffer with stream style appends. Used on its own to
+ * format the result of one query, possibly on a worker thread, before it
+ * is committed to an OutputWriter.
+ */
+class OutputBuffer {
+	protected:
+		char * data;           // formatted bytes
+		size_t length;         // bytes used
+		size_t capacity;       // bytes allocated
+
+        /**
+         * Makes room for more bytes. The plain buffer grows; the writer
+         * hands the full buffer to its thread instead.
+         * Parameters:
+         *      needed: Bytes about to be appended
+         *
+         */
+		virtual void overflow(size_t needed);
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      size: Initial capacity in bytes
+         */
+		OutputBuffer(size_t size = 4096);
+
+        /**
+         * Destructor
+         */
+		virtual ~OutputBuffer();
+
+		OutputBuffer(const OutputBuffer&) = delete;
+		OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        /**
+         * Appends raw bytes
+         * Parameters:
+         *      bytes: Bytes to append
+         *      count: Number of bytes
+         *
+         */
+		void append(const char * bytes, size_t count){
+			if (length + count > capacity)
+				overflow(count);
+			memcpy(data + length, bytes, count);
+			length += count;
+		}
+
+        /**
+         * Appends the decimal form of an integer
+         * Parameters:
+         *      value: Integer to append
+         *
+         */
+		void appendInt(long long value);
+
+		OutputBuffer& operator<<(const string& text){
+			append(text.data(), text.size());
+			return *this;
+		}
+
+		OutputBuffer& operator<<(const char * text){
+			append(text, strlen(text));
+			return *this;
+		}
+
+		OutputBuffer& operator<<(char c){
+			append(&c, 1);
+			return *this;
+		}
+
+		OutputBuffer& operator<<(int value){
+			appendInt(value);
+			return *this;
+		}
+
+		OutputBuffer& operator<<(long value){
+			appendInt(value);
+			return *this;
+		}
+
+		OutputBuffer& operator<<(long long value){
+			appendInt(value);
+			return *this;
+		}
+
+        /**
+         * Bytes formatted so far
+         */
+		const char * bytes() const { return data; }
+
+        /**
+         * Number of bytes formatted so far
+         */
+		size_t size() const { return length; }
+
+        /**
+         * Drops the formatted bytes, keeping the memory
+         */
+		void clear() { length = 0; }
+};
+
+/**
+ * Buffered file writer. Appends fill the current buffer; a full buffer is
+ * queued for the background thread and a spare one takes its place, so at
+ * most a fixed number of buffers exist. Results formatted in parallel are
+ * committed with their query number and written in query order.
+ */
+class OutputWriter : public OutputBuffer {
+	private:
+		int fd;                            // file written to, -1 if closed
+		size_t bufferSize;                 // capacity of each buffer
+		int buffersLeft;                   // buffers that may still be made
+		bool failed;                       // a write to the file failed
+		bool closing;                      // no more buffers will be queued
+		deque<pair<char *, size_t>> full;  // buffers waiting to be written
+		vector<char *> spare;              // buffers written already
+		mutex lock;                        // guards the members above
+		condition_variable ready;          // a buffer was queued or freed
+		thread worker;                     // writes the queued buffers
+
+		map<long, string> pending;         // results committed out of order
+		long nextSequence;                 // next result in query order
+		mutex commitLock;                  // guards pending and nextSequence
+
+        /**
+         * Queues the current buffer for the thread and takes a spare one
+         * Parameters:
+         *      needed: Bytes about to be appended
+         *
+         */
+		virtual void overflow(size_t needed);
+
+        /**
+         * Body of the background thread
+         */
+		void writeLoop();
+
+	public:
+        /**
+         * Constructor, truncates or creates the file
+         * Parameters:
+         *      out_filename: File to write
+         *      size: Capacity of each buffer in bytes
+         */
+		OutputWriter(const char * out_filename, size_t size = 1 << 20);
+
+        /**
+         * Destructor, writes everything still buffered
+         */
+		virtual ~OutputWriter();
+
+        /**
+         * Whether the file is open and every write so far succeeded
+         */
+		bool good();
+
+        /**
+         * Appends the result of one query once every earlier query has
+         * been appended. Safe to call from several threads.
+         * Parameters:
+         *      sequence: Number of the query, counting from 0
+         *      result: Formatted result of the query
+         *
+         */
+		void commit(long sequence, const OutputBuffer& result);
+
+        /**
+         * Writes everything still buffered and closes the file. Nothing
+         * may be appended afterwards.
+         *
+         * Return: true if every write succeeded, false otherwise
+         */
+		bool close();
+};
+
+#endif // OUTPUTWRITER_H
@@ -0,0 +1,158 @@
+/*
+ * ParallelFor.hpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   November 29, 2016
+ *
+ * This file declares and defines the thread helpers shared by the
+ * threaded modules: how a requested thread count is resolved, a pool of
+ * worker threads that lives across many parallel phases, and a loop that
+ * hands independent items out to the workers.
+ */
+#ifndef PARALLELFOR_HPP
+#define PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "Barrier.hpp"
+
+using namespace std;
+
+/**
+ * Number of worker threads to use for a requested count
+ * Parameters:
+ *      threads: Requested number of threads, 0 or less for one per core
+ *
+ * Return: threads if positive, else the number of cores, at least 1
+ */
+inline int resolveThreads(int threads){
+	if (threads <= 0)
+		threads = thread::hardware_concurrency();
+	if (threads <= 0)
+		threads = 1;
+	return threads;
+}
+
+/**
+ * Class to define member variables and methods of a pool of worker
+ * threads. The workers are started once and meet at a barrier around every
+ * phase, so a caller running many short phases does not pay for starting
+ * and joining threads each time. The calling thread takes part in every
+ * phase as thread 0.
+ *
+ */
+class WorkerPool{
+	int numThreads;                 // threads of a phase, caller included
+	Barrier phase;                  // start and end of every phase
+	function<void(int)> job;        // work of the current phase
+	bool stopping;                  // the pool is closing, workers return
+	vector<thread> workers;         // threads 1 to numThreads - 1
+
+        /**
+         * Loop of a worker thread: waits for a phase, runs its part and
+         * waits for the others, until the pool is closed
+         * Parameters:
+         *      t: Thread number, from 1
+         *
+         */
+		void loop(int t){
+			while (true){
+				phase.wait();
+				if (stopping)
+					return;
+				job(t);
+				phase.wait();
+			}
+		}
+
+	public:
+        /**
+         * Constructor, starts the workers
+         * Parameters:
+         *      threads: Number of threads, 0 or less for one per core
+         */
+		WorkerPool(int threads) : numThreads(resolveThreads(threads)),
+		                          phase(numThreads), stopping(false) {
+			for (int t = 1; t < numThreads; t++)
+				workers.push_back(thread(&WorkerPool::loop, this, t));
+		}
+
+        /**
+         * Destructor, stops and joins the workers
+         */
+		~WorkerPool(){
+			stopping = true;
+			if (numThreads > 1)
+				phase.wait();
+			for (thread& worker : workers)
+				worker.join();
+		}
+
+        /**
+         * Number of threads of a phase
+         *
+         * Return: numThreads
+         */
+		int size() const { return numThreads; }
+
+        /**
+         * Runs work(thread) on every thread of the pool and waits for all
+         * of them
+         * Parameters:
+         *      work: Function to run, thread numbers are in [0, size())
+         *
+         */
+		void run(function<void(int)> work){
+			if (numThreads == 1){
+				work(0);
+				return;
+			}
+			job = work;
+			phase.wait();
+			job(0);
+			phase.wait();
+			job = nullptr;
+		}
+
+        /**
+         * Runs work(item, thread) for every item in [0, count), handing
+         * out grain items at a time to whichever thread is free
+         * Parameters:
+         *      count: Number of items
+         *      work: Function to run for every item
+         *      grain: Items taken at once, more for cheap items
+         *
+         */
+		void parallelFor(int count, function<void(int, int)> work,
+		                 int grain = 1){
+			atomic<int> next(0);       // next item nobody has taken yet
+			run([&](int t){
+				for (int first = next.fetch_add(grain); first < count;
+				                             first = next.fetch_add(grain)){
+					int last = min(first + grain, count);
+					for (int item = first; item < last; item++)
+						work(item, t);
+				}
+			});
+		}
+};
+
+/**
+ * Runs work(item, thread) for every item in [0, count) on up to threads
+ * worker threads, handing out items one at a time. Thread numbers are in
+ * [0, threads), so a caller can keep per-thread scratch space.
+ * Parameters:
+ *      threads: Number of worker threads
+ *      count: Number of items
+ *      work: Function to run for every item
+ *
+ */
+inline void parallelFor(int threads, int count,
+                        function<void(int, int)> work){
+	WorkerPool pool(min(threads, max(count, 1)));
+	pool.parallelFor(count, work);
+}
+
+#endif // PARALLELFOR_HPP
@@ -0,0 +1,228 @@
+/*
+ * SearchEngine.hpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 5, 2016
+ *
+ * This file declares the weight, queue and heuristic policies of the search
+ * core and defines ActorGraph::search, the one loop behind Dijkstra, AStar
+ * and any other cost model. The policies are template parameters, so every
+ * combination is compiled on its own: unit weights with a FIFO queue are a
+ * plain BFS, with no heap and no bound lookups.
+ */
+#ifndef SEARCHENGINE_HPP
+#define SEARCHENGINE_HPP
+
+#include <climits>
+#include <queue>
+#include <vector>
+#include "ActorGraph.h"
+#include "Landmarks.h"
+
+using namespace std;
+
+// year the recency weights are counted back from by default
+#define DEFAULT_REFERENCE_YEAR 2016
+
+/**
+ * Weight policy: every edge costs one hop
+ */
+struct UnitWeight{
+    int operator()(const ActorEdge&) const {
+        return 1;
+    }
+};
+
+/**
+ * Weight policy: an edge costs the age of its movie relative to a reference
+ * year, so recent movies are cheap links. The reference has to be at least
+ * the latest year in the data to keep the weights non-negative.
+ */
+struct RecencyWeight{
+    int reference;      // year an edge costs nothing in
+
+    RecencyWeight(int year = DEFAULT_REFERENCE_YEAR) : reference(year) {}
+
+    int operator()(const ActorEdge& edge) const {
+        return reference - edge.year;
+    }
+};
+
+/**
+ * Queue policy: first in first out. Only correct for unit weights, where
+ * the first path found to an actor is a shortest one, so the search stops
+ * as soon as the target is reached.
+ */
+class FifoQueue{
+    vector<int> items;  // every actor pushed, in order
+    size_t head;        // next actor to pop
+
+public:
+    static const bool settlesOnPush = true;
+
+    FifoQueue() : head(0) {}
+
+    void push(int actor, int){
+        items.push_back(actor);
+    }
+
+    int pop(){
+        return items[head++];
+    }
+
+    bool empty() const {
+        return head == items.size();
+    }
+};
+
+/**
+ * Queue policy: binary heap on the key, lowest first. Actors are pushed
+ * again when their key drops and the stale entries are skipped when popped.
+ */
+class HeapQueue{
+    priority_queue<pair<int,int>, vector<pair<int,int>>, ActorNodeComp> heap;
+
+public:
+    static const bool settlesOnPush = false;
+
+    void push(int actor, int key){
+        heap.push(make_pair(actor, key));
+    }
+
+    int pop(){
+        int actor = heap.top().first;
+        heap.pop();
+        return actor;
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+};
+
+/**
+ * Heuristic policy: no estimate of the distance left, plain Dijkstra
+ */
+struct NoHeuristic{
+    int operator()(int) const {
+        return 0;
+    }
+};
+
+/**
+ * Heuristic policy: landmark lower bound on the weighted distance left to
+ * the target, INT_MAX when the target cannot be reached. Only valid with
+ * the weights the landmarks were built with.
+ */
+struct LandmarkHeuristic{
+    const Landmarks& landmarks;     // landmark distance table
+    int target;                     // actor the search heads for
+
+    LandmarkHeuristic(const Landmarks& table, int toActor) :
+                                         landmarks(table), target(toActor) {}
+
+    int operator()(int actor) const {
+        return landmarks.lowerBound(actor, target);
+    }
+};
+
+/**
+ * Best first search shared by every cost model
+ * Parameters:
+ *      fromActor: index of Actor to start from
+ *      toActor: index of Actor to stop at, or -1 to reach every actor
+ *      maxYear: Only movies released up to this year link actors
+ *      weight: Cost of an edge, called as weight(ActorEdge)
+ *      heuristic: Lower bound on the cost left, called as heuristic(actor)
+ *
+ */
+template<typename Queue, typename Weight, typename Heuristic>
+void ActorGraph::search(int fromActor, int toActor, int maxYear,
+                           const Weight& weight, const Heuristic& heuristic){
+	search<Queue>(fromActor,
+	              toActor < 0 ? vector<int>() : vector<int>(1, toActor),
+	              maxYear, weight, heuristic);
+}
+
+/**
+ * Best first search shared by every cost model. The queue is ordered by
+ * the distance plus the heuristic; an actor is final the first time it is
+ * popped, or the first time it is pushed with a settlesOnPush queue. The
+ * search stops once every target is final.
+ * Parameters:
+ *      fromActor: index of Actor to start from
+ *      targets: indices of Actors to stop at, empty to reach every actor
+ *      maxYear: Only movies released up to this year link actors
+ *      weight: Cost of an edge, called as weight(ActorEdge)
+ *      heuristic: Lower bound on the cost left, called as heuristic(actor)
+ *
+ */
+template<typename Queue, typename Weight, typename Heuristic>
+void ActorGraph::search(int fromActor, const vector<int>& targets,
+                        int maxYear, const Weight& weight,
+                                                 const Heuristic& heuristic){
+	search<Queue>(state, fromActor, targets, maxYear, weight, heuristic);
+}
+
+/**
+ * Best first search writing to the given search fields only, so threads
+ * with their own state may search one graph at once
+ * Parameters:
+ *      state: Fields of the search
+ *      fromActor: index of Actor to start from
+ *      targets: indices of Actors to stop at, empty to reach every actor
+ *      maxYear: Only movies released up to this year link actors
+ *      weight: Cost of an edge, called as weight(ActorEdge)
+ *      heuristic: Lower bound on the cost left, called as heuristic(actor)
+ *
+ */
+template<typename Queue, typename Weight, typename Heuristic>
+void ActorGraph::search(SearchState& state, int fromActor,
+                        const vector<int>& targets, int maxYear,
+                        const Weight& weight, const Heuristic& heuristic) const {
+
+	initialize(state);      // Initializes node fields to default values
+	int * dist = state.dist.data();
+	int * prev = state.prev.data();
+	char * done = state.done.data();
+	dist[fromActor] = 0;           // the start actor is at distance zero
+	int remaining = markTargets(state, fromActor, targets); // not final
+	const int * wanted = state.wanted.data();
+	int searchStamp = state.stamp;
+	if (targets.empty())
+		remaining = -1;
+	if (remaining == 0)
+		return;
+	Queue queue;
+	queue.push(fromActor, heuristic(fromActor));
+
+	while (!queue.empty()){
+		int curr = queue.pop();
+		if (done[curr])
+			continue;
+		done[curr] = true;
+		if (!Queue::settlesOnPush && wanted[curr] == searchStamp &&
+		                                                  --remaining == 0)
+			return;
+		if (state.expand())
+			return;
+
+		for (const ActorEdge& edge : edgesOf(curr, maxYear)){
+			int neighbor = edge.actor;
+			int distance = dist[curr] + weight(edge);
+			if (distance >= dist[neighbor])
+				continue;
+			prev[neighbor] = curr;
+			dist[neighbor] = distance;
+			if (Queue::settlesOnPush && wanted[neighbor] == searchStamp &&
+			                                              --remaining == 0)
+				return;
+
+			// an actor which cannot reach toActor is never queued
+			int bound = heuristic(neighbor);
+			if (bound != INT_MAX)
+				queue.push(neighbor, distance + bound);
+		}
+	}
+}
+
+#endif // SEARCHENGINE_HPP
@@ -0,0 +1,234 @@
+/*
+ * Separation.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   November 29, 2016
+ *
+ * Implements the whole-graph separation statistics declared in
+ * Separation.h.
+ */
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Separation.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * Parameters:
+ *      adjacency: Graph to analyze, must outlive the object
+ *      threads: Number of worker threads, 0 for one per core
+ */
+SeparationAnalytics::SeparationAnalytics(const Adjacency& adjacency,
+                                         int threads) : graph(adjacency) {
+	numThreads = resolveThreads(threads);
+}
+
+/**
+ * BFS from one actor using the scratch space of one thread. dist keeps the
+ * distances of this search, and queue the actors it reached, until the
+ * next call with the same scratch space.
+ * Parameters:
+ *      source: index of Actor to start from
+ *      dist: Scratch distances, -1 for every actor not in queue
+ *      queue: Scratch queue, actors reached by the previous search
+ *      histogram: Number of actors found at each hop distance is added
+ *                 here, may be NULL
+ *
+ * Return: Eccentricity of source within its component
+ */
+int SeparationAnalytics::bfs(int source, vector<int>& dist,
+                          vector<int>& queue, vector<long long>* histogram){
+	// undo the previous search
+	for (int actor : queue)
+		dist[actor] = -1;
+	queue.clear();
+
+	dist[source] = 0;
+	queue.push_back(source);
+	for (size_t head = 0; head < queue.size(); head++){
+		int curr = queue[head];
+		int next = dist[curr] + 1;
+		for (int k = graph.offsets[curr]; k < graph.offsets[curr + 1]; k++){
+			int neighbor = graph.targets[k];
+			if (dist[neighbor] == -1){
+				dist[neighbor] = next;
+				queue.push_back(neighbor);
+			}
+		}
+	}
+
+	int eccentricity = dist[queue.back()];
+	if (histogram){
+		if ((int)histogram->size() <= eccentricity)
+			histogram->resize(eccentricity + 1, 0);
+		for (size_t k = 1; k < queue.size(); k++)
+			(*histogram)[dist[queue[k]]]++;
+	}
+	return eccentricity;
+}
+
+/**
+ * Number of ordered actor pairs at each hop distance. Exact when samples is
+ * 0, otherwise counted from that many random sources.
+ * Parameters:
+ *      samples: Number of BFS sources, 0 for all actors
+ *      seed: Seed for picking the sources
+ *      unreachable: Filled with the number of pairs not connected
+ *
+ * Return: Entry h is the number of pairs h hops apart, h >= 1
+ */
+vector<long long> SeparationAnalytics::distanceDistribution(int samples,
+                                   unsigned seed, long long& unreachable){
+	int size = graph.size();
+	vector<int> sources;
+	if (samples <= 0 || samples >= size){
+		for (int actor = 0; actor < size; actor++)
+			sources.push_back(actor);
+	}
+	else{
+		mt19937 random(seed);
+		uniform_int_distribution<int> pick(0, size - 1);
+		for (int k = 0; k < samples; k++)
+			sources.push_back(pick(random));
+	}
+
+	// every thread keeps its own scratch space and histogram
+	vector<vector<int>> dist(numThreads, vector<int>(size, -1));
+	vector<vector<int>> queue(numThreads);
+	vector<vector<long long>> histogram(numThreads);
+	vector<long long> reached(numThreads, 0);
+
+	parallelFor(numThreads, sources.size(), [&](int item, int t){
+		bfs(sources[item], dist[t], queue[t], &histogram[t]);
+		reached[t] += queue[t].size() - 1;
+	});
+
+	vector<long long> total;
+	long long pairs = 0;
+	for (int t = 0; t < numThreads; t++){
+		if (total.size() < histogram[t].size())
+			total.resize(histogram[t].size(), 0);
+		for (size_t h = 0; h < histogram[t].size(); h++)
+			total[h] += histogram[t][h];
+		pairs += reached[t];
+	}
+	unreachable = (long long)sources.size() * (size - 1) - pairs;
+	return total;
+}
+
+/**
+ * Exact diameter of the largest connected component, using the iFUB
+ * bounds: after a BFS from a central actor u, only the actors on the
+ * outermost levels of that BFS need their own search, level by level, until
+ * the lower bound beats twice the next level.
+ * Parameters:
+ *      searches: Filled with the number of BFS runs used
+ *
+ * Return: Largest hop distance between two connected actors
+ */
+int SeparationAnalytics::diameter(int& searches){
+	int size = graph.size();
+	searches = 0;
+	if (size == 0)
+		return 0;
+
+	vector<int> dist(size, -1);
+	vector<int> queue;
+
+	// start from the highest degree actor of the largest component
+	vector<int> component(size, -1);
+	int largestSize = 0;
+	int start = 0;
+	for (int actor = 0; actor < size; actor++){
+		if (component[actor] != -1)
+			continue;
+		bfs(actor, dist, queue, NULL);
+		int hub = actor;
+		for (int member : queue){
+			component[member] = actor;
+			if (graph.degree(member) > graph.degree(hub))
+				hub = member;
+		}
+		if ((int)queue.size() > largestSize){
+			largestSize = queue.size();
+			start = hub;
+		}
+	}
+
+	// 4-sweep: two double sweeps, each ending at the middle of a long path
+	int lower = 0;
+	int center = start;
+	for (int sweep = 0; sweep < 2; sweep++){
+		bfs(center, dist, queue, NULL);
+		int far = queue.back();
+		int eccentricity = bfs(far, dist, queue, NULL);
+		searches += 2;
+		lower = max(lower, eccentricity);
+
+		// walk half way back from the far end of the path
+		int curr = queue.back();
+		for (int step = 0; step < eccentricity / 2; step++){
+			for (int k = graph.offsets[curr]; k < graph.offsets[curr + 1];
+			                                                           k++){
+				int neighbor = graph.targets[k];
+				if (dist[neighbor] == dist[curr] - 1){
+					curr = neighbor;
+					break;
+				}
+			}
+		}
+		center = curr;
+	}
+
+	// fringe levels of the BFS from the center
+	int level = bfs(center, dist, queue, NULL);
+	searches++;
+	lower = max(lower, level);
+	vector<vector<int>> fringe(level + 1);
+	for (int actor : queue)
+		fringe[dist[actor]].push_back(actor);
+
+	vector<vector<int>> scratchDist(numThreads, vector<int>(size, -1));
+	vector<vector<int>> scratchQueue(numThreads);
+	vector<int> best(numThreads, 0);
+
+	// every pair with both ends inside level i - 1 is at most 2(i - 1)
+	// apart, so once the lower bound exceeds that it is the diameter
+	while (level > 0 && 2 * level > lower){
+		vector<int>& actors = fringe[level];
+		parallelFor(numThreads, actors.size(), [&](int item, int t){
+			int eccentricity = bfs(actors[item], scratchDist[t],
+			                       scratchQueue[t], NULL);
+			best[t] = max(best[t], eccentricity);
+		});
+		searches += actors.size();
+		for (int t = 0; t < numThreads; t++)
+			lower = max(lower, best[t]);
+		if (lower > 2 * (level - 1))
+			break;
+		level--;
+	}
+
+	return lower;
+}
+
+/**
+ * Eccentricity of each of the given actors
+ * Parameters:
+ *      actors: indices of the actors
+ *
+ * Return: Eccentricity of actors[i] at position i
+ */
+vector<int> SeparationAnalytics::eccentricities(const vector<int>& actors){
+	int size = graph.size();
+	vector<int> result(actors.size(), 0);
+	vector<vector<int>> dist(numThreads, vector<int>(size, -1));
+	vector<vector<int>> queue(numThreads);
+
+	parallelFor(numThreads, actors.size(), [&](int item, int t){
+		result[item] = bfs(actors[item], dist[t], queue[t], NULL);
+	});
+	return result;
+}
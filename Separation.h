@@ -0,0 +1,87 @@
+/*
+ * Separation.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    November 29, 2016
+ *
+ * Defines the SeparationAnalytics class, which computes "degrees of
+ * separation" statistics over the whole actor graph: the hop distance
+ * distribution, the exact diameter and the eccentricity of chosen actors.
+ * Every statistic is a batch of independent BFS runs spread over threads
+ * that share one read only Adjacency.
+ */
+
+#ifndef SEPARATION_H
+#define SEPARATION_H
+
+#include <vector>
+#include <functional>
+#include "Adjacency.h"
+#include "ParallelFor.hpp"
+
+using namespace std;
+
+/**
+ * Whole-graph separation statistics over an Adjacency
+ */
+class SeparationAnalytics {
+	private:
+		const Adjacency& graph;   // graph shared by all the threads
+		int numThreads;           // worker threads per batch
+
+        /**
+         * BFS from one actor using the scratch space of one thread
+         * Parameters:
+         *      source: index of Actor to start from
+         *      dist: Scratch distances, all -1 on entry and on return
+         *      queue: Scratch queue
+         *      histogram: Number of actors found at each hop distance is
+         *                 added here, may be NULL
+         *
+         * Return: Eccentricity of source within its component
+         */
+		int bfs(int source, vector<int>& dist, vector<int>& queue,
+		                                      vector<long long>* histogram);
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      adjacency: Graph to analyze, must outlive the object
+         *      threads: Number of worker threads, 0 for one per core
+         */
+		SeparationAnalytics(const Adjacency& adjacency, int threads);
+
+        /**
+         * Number of ordered actor pairs at each hop distance. Exact when
+         * samples is 0, otherwise counted from that many random sources.
+         * Parameters:
+         *      samples: Number of BFS sources, 0 for all actors
+         *      seed: Seed for picking the sources
+         *      unreachable: Filled with the number of pairs not connected
+         *
+         * Return: Entry h is the number of pairs h hops apart, h >= 1
+         */
+		vector<long long> distanceDistribution(int samples, unsigned seed,
+		                                       long long& unreachable);
+
+        /**
+         * Exact diameter of the largest connected component, using the
+         * iFUB bounds so only a few fringe actors need their own BFS
+         * Parameters:
+         *      searches: Filled with the number of BFS runs used
+         *
+         * Return: Largest hop distance between two connected actors
+         */
+		int diameter(int& searches);
+
+        /**
+         * Eccentricity of each of the given actors
+         * Parameters:
+         *      actors: indices of the actors
+         *
+         * Return: Eccentricity of actors[i] at position i
+         */
+		vector<int> eccentricities(const vector<int>& actors);
+};
+
+#endif // SEPARATION_H
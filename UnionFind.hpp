@@ -2,142 +2,234 @@
  * UnionFind.hpp
  * Author: Haiyu Huang, Kyle Chang
  * Date:   November 13, 2016
- * 
- * This file is meant to declare and define member fields and member methods 
- * used to perform ufind in actor connections
+ *
+ * This file is meant to declare and define member fields and member methods
+ * used to perform ufind in actor connections. The disjoint set is a template
+ * over three policies: how find compresses the path it walks, which root
+ * merge links under the other, and how the elements are stored. graphbench
+ * times every combination on the merges of the cast data; UnionFind is the
+ * fastest one.
  */
 #ifndef UNIONFIND_HPP
 #define UNIONFIND_HPP
 
-#include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <utility>
 #include "ActorGraph.h"
 
 
 using namespace std;
 
 /**
- * Class to define member variables and methods related to the UnionFind data
- * structure used in actor connections.
- *
- */   
-class UnionFind{
-	friend class ActorGraph; // Has access to private members of ActorGraph 
-
-	pair<int,int> * dataArray; // a pair of index of node/size of set it's in
-	int arrayLength;		   // length of the dataArray
+ * Storage policy: one 32 bit word per element. A root holds the negated
+ * weight of its set, any other element the index of its parent.
+ */
+class PackedStorage{
+	int * data;         // parent, or -weight of a root
 
 public:
-    /** 
-     * Constructor for UnionFind object
-     * Parameters: 
-     *      graph: Graph to make UnionFind data structure from
-     */ 
-	UnionFind(ActorGraph& graph);
+	PackedStorage(int size) : data(new int[size]) {
+		fill_n(data, size, -1);
+	}
 
-	/**
-     * Destructor for UnionFind objects
-     */   
-    ~UnionFind();
+	~PackedStorage(){
+		delete[] data;
+	}
 
-    /**
-     * Finds set based on node inputed
-     * Parameters:
-     *      node: Index of actor node to find
-     *
-     * Return: Sentinel Node index of set node is in. 
-     */ 
-	int find(int node);
+	PackedStorage(const PackedStorage&) = delete;
+	PackedStorage& operator=(const PackedStorage&) = delete;
 
-    /**
-     * Finds which set object is inside based on node. 
-     * Parameters:
-     *      node: Index of actor to find
-     *
-     * Return: Sentinel of set which actor is in   
-     */ 
-	void merge(int left, int right);
+	bool isRoot(int node) const { return data[node] < 0; }
+	int parent(int node) const { return data[node]; }
+	void setParent(int node, int parent){ data[node] = parent; }
+	int weight(int root) const { return -data[root]; }
+	void setWeight(int root, int weight){ data[root] = -weight; }
+};
 
+/**
+ * Storage policy: a pair of parent, -1 for a root, and weight per element,
+ * the layout UnionFind used to have
+ */
+class PairStorage{
+	pair<int,int> * data;   // parent and weight of every element
+
+public:
+	PairStorage(int size) : data(new pair<int,int>[size]) {
+		fill_n(data, size, make_pair(-1, 1));
+	}
+
+	~PairStorage(){
+		delete[] data;
+	}
+
+	PairStorage(const PairStorage&) = delete;
+	PairStorage& operator=(const PairStorage&) = delete;
+
+	bool isRoot(int node) const { return data[node].first == -1; }
+	int parent(int node) const { return data[node].first; }
+	void setParent(int node, int parent){ data[node].first = parent; }
+	int weight(int root) const { return data[root].second; }
+	void setWeight(int root, int weight){ data[root].second = weight; }
 };
 
 /**
- * Destructor for UnionFind object
- */ 
-UnionFind::~UnionFind(){
-	delete dataArray;
-}
+ * Compression policy: every element on the path is attached to the root,
+ * in a second pass once the root is known
+ */
+struct FullCompression{
+	template<typename Storage>
+	static int find(Storage& storage, int node){
+		int root = node;
+		while (!storage.isRoot(root))
+			root = storage.parent(root);
+		while (node != root){
+			int next = storage.parent(node);
+			storage.setParent(node, root);
+			node = next;
+		}
+		return root;
+	}
+};
 
 /**
- * Constructor for UnionFind object
- * Parameters:
- *      graph: Graph to make UnionFind data structure from 
- */ 
-UnionFind::UnionFind(ActorGraph& graph){
-    
-    // Creates set, and fills arrayLength items after dataArray with default values.
-	arrayLength = graph.actorSet.size();
-	dataArray = new pair<int,int>[arrayLength];
-	fill_n (dataArray, arrayLength, make_pair(-1,1));
-}
+ * Compression policy: every other element on the path is attached to its
+ * grandparent, in one pass
+ */
+struct PathHalving{
+	template<typename Storage>
+	static int find(Storage& storage, int node){
+		while (!storage.isRoot(node)){
+			int parent = storage.parent(node);
+			if (storage.isRoot(parent))
+				return parent;
+			storage.setParent(node, storage.parent(parent));
+			node = storage.parent(node);
+		}
+		return node;
+	}
+};
 
 /**
- * Finds which set object is inside based on node. 
- * Parameters:
- *      node: Index of actor to find
- *      
- * Return: Sentinel of set which actor is in   
- */ 
-int UnionFind::find(int node){
-	// for path compression to attach all nodes passed to the sentinel nodes
-	vector<int> toAttach;	
-
-	// go up to search for the sentinal node
-	int curr = node;
-
-	// go up the up-tree to find the sentinel node
-	while ( dataArray[curr].first != -1 ){
-		toAttach.push_back(curr);
-		curr = dataArray[curr].first;
+ * Compression policy: every element on the path is attached to its
+ * grandparent, in one pass
+ */
+struct PathSplitting{
+	template<typename Storage>
+	static int find(Storage& storage, int node){
+		while (!storage.isRoot(node)){
+			int parent = storage.parent(node);
+			if (storage.isRoot(parent))
+				return parent;
+			storage.setParent(node, storage.parent(parent));
+			node = parent;
+		}
+		return node;
 	}
+};
 
-	// path compression
-	for (int num: toAttach){
-		dataArray[num].first = curr;
-	}	
+/**
+ * Union policy: the root of the smaller set goes under the other
+ */
+struct UnionBySize{
+	template<typename Storage>
+	static void link(Storage& storage, int left, int right){
+		int sum = storage.weight(left) + storage.weight(right);
+		if (storage.weight(left) < storage.weight(right))
+			swap(left, right);
+		storage.setParent(right, left);
+		storage.setWeight(left, sum);
+	}
+};
 
-	return curr;
+/**
+ * Union policy: the root of the lower tree goes under the other. Ranks
+ * are stored one up, since a weight has to be positive.
+ */
+struct UnionByRank{
+	template<typename Storage>
+	static void link(Storage& storage, int left, int right){
+		if (storage.weight(left) < storage.weight(right))
+			swap(left, right);
+		else if (storage.weight(left) == storage.weight(right))
+			storage.setWeight(left, storage.weight(left) + 1);
+		storage.setParent(right, left);
+	}
+};
 
+/**
+ * Union policy: roots are ordered by a fixed pseudo random priority of
+ * their index, and the lower one goes under the other. No weight is kept.
+ */
+struct UnionByIndex{
+	static uint32_t priority(int node){
+		uint32_t hash = (uint32_t)node * 0x9e3779b1u;
+		return hash ^ (hash >> 16);
+	}
 
-}
+	template<typename Storage>
+	static void link(Storage& storage, int left, int right){
+		if (priority(left) < priority(right))
+			swap(left, right);
+		storage.setParent(right, left);
+	}
+};
 
 /**
- * Merges two sets. Left and right are nodes from sets.
- * Parameters: 
- *      left: Index of Actor
- *      right: Index of Actor 
- */ 
-void UnionFind::merge(int left, int right){
-	// find the left and right sentinel node respectively
-	int leftSentinel = find(left);
-	int rightSentinel = find(right);
-
-	// already merged
-	if (leftSentinel == rightSentinel)
-		return;
-
-	// update size
-	int sum = dataArray[leftSentinel].second + dataArray[rightSentinel].second;
-
-	// compare size of sets
-	if (dataArray[leftSentinel].second < dataArray[rightSentinel].second){
-		dataArray[leftSentinel].first = rightSentinel;
-		dataArray[rightSentinel].second = sum;
+ * Class to define member variables and methods related to the disjoint set
+ * data structure used in actor connections.
+ *
+ */
+template<typename Compression, typename Union, typename Storage>
+class DisjointSet{
+	Storage storage;        // parent and weight of every element
+
+public:
+    /**
+     * Constructor, every element in a set of its own
+     * Parameters:
+     *      size: Number of elements
+     */
+	DisjointSet(int size) : storage(size) {}
+
+    /**
+     * Constructor for UnionFind object
+     * Parameters:
+     *      graph: Graph to make UnionFind data structure from
+     */
+	DisjointSet(ActorGraph& graph) : storage(graph.size()) {}
+
+    /**
+     * Finds set based on node inputed
+     * Parameters:
+     *      node: Index of actor node to find
+     *
+     * Return: Sentinel Node index of set node is in.
+     */
+	int find(int node){
+		return Compression::find(storage, node);
 	}
-	else{
-		dataArray[rightSentinel].first = leftSentinel;
-		dataArray[leftSentinel].second = sum;
+
+    /**
+     * Merges two sets. Left and right are nodes from sets.
+     * Parameters:
+     *      left: Index of Actor
+     *      right: Index of Actor
+     */
+	void merge(int left, int right){
+		// find the left and right sentinel node respectively
+		int leftSentinel = find(left);
+		int rightSentinel = find(right);
+
+		// already merged
+		if (leftSentinel == rightSentinel)
+			return;
+		Union::link(storage, leftSentinel, rightSentinel);
 	}
-}
+};
+
+// fastest combination in the graphbench --unionfind matrix
+typedef DisjointSet<PathSplitting, UnionByRank, PackedStorage> UnionFind;
 
 
 #endif // UNIONFIND_HPP
@@ -0,0 +1,163 @@
+/*
+ * VersionedGraph.cpp
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:   December 8, 2016
+ *
+ * Implements the versioned graph declared in VersionedGraph.h.
+ */
+#include <climits>
+#include "VersionedGraph.h"
+
+using namespace std;
+
+/**
+ * Constructor, publishes the first version in epoch 1. Epoch 0 marks a
+ * slot that holds no version.
+ * Parameters:
+ *      graph: First version, stays owned by the caller
+ */
+VersionedGraph::VersionedGraph(ActorGraph * graph) :
+                                  first(graph), current(graph), epoch(1) {
+	for (int slot = 0; slot < READER_SLOTS; slot++){
+		pinned[slot].store(0);
+		claimed[slot].store(false);
+	}
+}
+
+/**
+ * Destructor, frees the current version and every replaced one but the
+ * first
+ */
+VersionedGraph::~VersionedGraph(){
+	for (auto & version : retired)
+		if (version.second != first)
+			delete version.second;
+	if (current.load() != first)
+		delete current.load();
+}
+
+/**
+ * Claims a reader slot
+ *
+ * Return: Index of the slot, -1 if every slot is taken
+ */
+int VersionedGraph::attach(){
+	for (int slot = 0; slot < READER_SLOTS; slot++){
+		bool free = false;
+		if (claimed[slot].compare_exchange_strong(free, true))
+			return slot;
+	}
+	return -1;
+}
+
+/**
+ * Gives a reader slot back
+ * Parameters:
+ *      slot: Slot from attach, not pinned
+ *
+ */
+void VersionedGraph::detach(int slot){
+	pinned[slot].store(0);
+	claimed[slot].store(false);
+}
+
+/**
+ * Pins the current version. The epoch is stored before the pointer is
+ * read, so a writer that swaps the pointer after that read sees the pin
+ * and keeps the version; a reader that reads after the swap gets the new
+ * version.
+ * Parameters:
+ *      slot: Slot from attach
+ *
+ * Return: Current version of the graph
+ */
+const ActorGraph * VersionedGraph::pin(int slot){
+	pinned[slot].store(epoch.load());
+	return current.load();
+}
+
+/**
+ * Releases the version pinned in a slot
+ * Parameters:
+ *      slot: Slot from attach
+ *
+ */
+void VersionedGraph::unpin(int slot){
+	pinned[slot].store(0);
+}
+
+/**
+ * Frees the replaced versions no pinned reader can still hold. A version
+ * replaced in epoch e may be held by readers that pinned e or earlier.
+ */
+void VersionedGraph::reclaim(){
+	unsigned long oldest = ULONG_MAX;   // earliest epoch still pinned
+	for (int slot = 0; slot < READER_SLOTS; slot++){
+		unsigned long pin = pinned[slot].load();
+		if (pin && pin < oldest)
+			oldest = pin;
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < retired.size(); i++){
+		if (retired[i].first < oldest){
+			if (retired[i].second != first)
+				delete retired[i].second;
+		}
+		else
+			retired[kept++] = retired[i];
+	}
+	retired.resize(kept);
+}
+
+/**
+ * Swaps in a new version and retires the one it replaces in the epoch
+ * before the bump. Called with the writer lock held.
+ * Parameters:
+ *      next: New version
+ *
+ */
+void VersionedGraph::replace(ActorGraph * next){
+	ActorGraph * replaced = current.exchange(next);
+	retired.push_back(make_pair(epoch.fetch_add(1), replaced));
+	reclaim();
+}
+
+/**
+ * Makes a graph the current version
+ * Parameters:
+ *      next: New version, owned by this object from now on
+ *
+ */
+void VersionedGraph::publish(ActorGraph * next){
+	lock_guard<mutex> lock(writer);
+	replace(next);
+}
+
+/**
+ * Copies the current version, applies a change to the copy and publishes
+ * it. The copy is made under the writer lock, so no other update is lost.
+ * Parameters:
+ *      change: Called on the copy, returns false to drop it
+ *
+ * Return: true if a new version was published, false otherwise
+ */
+bool VersionedGraph::update(const function<bool(ActorGraph&)>& change){
+	lock_guard<mutex> lock(writer);
+	ActorGraph * next = current.load()->clone();
+	if (!change(*next)){
+		delete next;
+		return false;
+	}
+	replace(next);
+	return true;
+}
+
+/**
+ * Number of versions published so far, the first one included
+ *
+ * Return: Current epoch
+ */
+unsigned long VersionedGraph::version() const {
+	return epoch.load();
+}
@@ -0,0 +1,170 @@
+/*
+ * VersionedGraph.h
+ * Author: Haiyu Huang, Kyle Chang
+ * Date:    December 8, 2016
+ *
+ * Defines the VersionedGraph class, which lets searches keep running while
+ * the graph is updated. Every version of the graph is immutable once it is
+ * published behind an atomic pointer. A reader pins the current epoch in
+ * its own slot and then reads the pointer, with no lock; a writer copies
+ * the current version, changes the copy off to the side and swaps it in.
+ * A replaced version is freed only once no reader pinned an epoch from
+ * before the swap, so a reader never sees a graph freed under it.
+ */
+
+#ifndef VERSIONEDGRAPH_H
+#define VERSIONEDGRAPH_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "ActorGraph.h"
+
+using namespace std;
+
+// most readers pinning versions at once
+#define READER_SLOTS 64
+
+/**
+ * Published versions of an ActorGraph. Readers attach once for a slot and
+ * pin around each use of a version; writers are serialized by a mutex that
+ * readers never take.
+ */
+class VersionedGraph {
+	private:
+		const ActorGraph * first;        // version owned by the caller
+		atomic<ActorGraph *> current;    // version new readers get
+		atomic<unsigned long> epoch;     // bumped by every publish
+		atomic<unsigned long> pinned[READER_SLOTS]; // epoch of a reader, 0
+		                                            // while it holds nothing
+		atomic<bool> claimed[READER_SLOTS];         // slot has a reader
+		mutex writer;                    // one publish at a time
+		vector<pair<unsigned long, ActorGraph *>> retired; // replaced
+		                                 // versions and the epoch they
+		                                 // were replaced in
+
+        /**
+         * Frees the replaced versions no pinned reader can still hold.
+         * Called with the writer lock held.
+         */
+		void reclaim();
+
+        /**
+         * Swaps in a new version and retires the replaced one. Called with
+         * the writer lock held.
+         * Parameters:
+         *      next: New version
+         *
+         */
+		void replace(ActorGraph * next);
+
+	public:
+        /**
+         * Constructor
+         * Parameters:
+         *      graph: First version, stays owned by the caller and has to
+         *             outlive this object
+         */
+		VersionedGraph(ActorGraph * graph);
+
+        /**
+         * Destructor, frees every version but the first. No reader may be
+         * pinned anymore.
+         */
+		~VersionedGraph();
+
+		VersionedGraph(const VersionedGraph&) = delete;
+		VersionedGraph& operator=(const VersionedGraph&) = delete;
+
+        /**
+         * Claims a reader slot
+         *
+         * Return: Index of the slot, -1 if every slot is taken
+         */
+		int attach();
+
+        /**
+         * Gives a reader slot back
+         * Parameters:
+         *      slot: Slot from attach, not pinned
+         *
+         */
+		void detach(int slot);
+
+        /**
+         * Pins the current version. It stays valid until unpin.
+         * Parameters:
+         *      slot: Slot from attach
+         *
+         * Return: Current version of the graph
+         */
+		const ActorGraph * pin(int slot);
+
+        /**
+         * Releases the version pinned in a slot
+         * Parameters:
+         *      slot: Slot from attach
+         *
+         */
+		void unpin(int slot);
+
+        /**
+         * Makes a graph the current version. The replaced version is freed
+         * once no reader holds it.
+         * Parameters:
+         *      next: New version, owned by this object from now on
+         *
+         */
+		void publish(ActorGraph * next);
+
+        /**
+         * Copies the current version, applies a change to the copy and
+         * publishes it. Writers run one at a time; readers go on with the
+         * version they pinned meanwhile.
+         * Parameters:
+         *      change: Called on the copy, returns false to drop it
+         *
+         * Return: true if a new version was published, false otherwise
+         */
+		bool update(const function<bool(ActorGraph&)>& change);
+
+        /**
+         * Number of versions published so far, the first one included
+         *
+         * Return: Current epoch
+         */
+		unsigned long version() const;
+};
+
+/**
+ * Scoped pin of the current version of a VersionedGraph
+ */
+class PinnedGraph {
+	private:
+		VersionedGraph& versions;   // graph the version belongs to
+		int slot;                   // reader slot pinned
+		const ActorGraph * graph;   // version pinned
+
+	public:
+		PinnedGraph(VersionedGraph& source, int reader) :
+		            versions(source), slot(reader), graph(source.pin(reader)) {}
+
+		~PinnedGraph() {
+			versions.unpin(slot);
+		}
+
+		PinnedGraph(const PinnedGraph&) = delete;
+		PinnedGraph& operator=(const PinnedGraph&) = delete;
+
+		const ActorGraph * operator->() const {
+			return graph;
+		}
+
+		const ActorGraph& operator*() const {
+			return *graph;
+		}
+};
+
+#endif // VERSIONEDGRAPH_H
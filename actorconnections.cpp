@@ -9,14 +9,19 @@
  */ 
 
 #include <chrono>
+#include <climits>
 #include <ctime>
 #include <fstream>
 #include <sstream>
 #include <set>
+#include <thread>
 #include <tuple>
 #include "ActorGraph.h"
 #include "UnionFind.hpp"
+#include "ConcurrentUnionFind.hpp"
+#include "ParallelFor.hpp"
 #define NUM_ARGS 5
+#define MERGE_GRAIN 1024    // merges or pairs a pufind worker takes at once
 using namespace std;
 
 int main(int argc, const char ** argv){
@@ -28,6 +33,7 @@ int main(int argc, const char ** argv){
 	// timer 
 	std::chrono::time_point<std::chrono::system_clock> start, end;
 	bool use_union;           // algorithmic implementation
+	bool use_parallel = false;// merge each year on several threads
 
 	// default to union if the forth argument is not given
 	if (argc == 4) {
@@ -37,11 +43,13 @@ int main(int argc, const char ** argv){
 	else{
 		const char * algorithm = argv[4];
 
-		if ( strcmp(algorithm, "ufind") && strcmp(algorithm, "bfs")) {
+		if ( strcmp(algorithm, "ufind") && strcmp(algorithm, "bfs") &&
+		                                        strcmp(algorithm, "pufind")) {
 			cerr << "Argument 4 (algorithm) invalid " << endl;
 			return -1;
 		}
-		use_union = ( !strcmp(algorithm, "ufind") );
+		use_parallel = ( !strcmp(algorithm, "pufind") );
+		use_union = ( !strcmp(algorithm, "ufind") ) || use_parallel;
 	}
 
 
@@ -52,6 +60,7 @@ int main(int argc, const char ** argv){
 	unordered_map<Movie, vector <int>> map;	// maps movie to actors in movie
 	multiset<const Movie *, MovieComp> tree;    // sort movie based on year
 	vector<tuple<int, int, int>> actorList;		// list of input actor pairs
+	vector<pair<string,string>> names;			// actor names of every pair
 
 	// load graph to the map
 	graph.loadFromFile(movie_casts, map);
@@ -63,7 +72,7 @@ int main(int argc, const char ** argv){
 
 	// Initialize the file stream
 	ifstream infile(in_filename);
-	ofstream outfile(out_filename);
+	OutputWriter outfile(out_filename);  // formats and writes in the back
 	bool have_header = false;
 
 	// output header
@@ -107,13 +116,69 @@ int main(int argc, const char ** argv){
 		int fromIndex = graph.locateActor(fromActor);
 		int toIndex = graph.locateActor(toActor);
 
-		// store the actor pairs with default year in the set of tuples
-		actorList.push_back( make_tuple(fromIndex, toIndex, year_connected) );
+		// store the actor pairs with default year in the set of tuples; a
+		// pair with a name missing from the graph gets a year before every
+		// movie, so no algorithm ever tests it
+		names.push_back(make_pair(fromActor, toActor));
+		if (fromIndex < 0 || toIndex < 0)
+			actorList.push_back( make_tuple(fromIndex, toIndex, INT_MIN) );
+		else
+			actorList.push_back( make_tuple(fromIndex, toIndex,
+			                                                year_connected) );
 
 	}
 
     // Runs corresponding algorithm
-	if (use_union){
+	if (use_parallel){
+		// the workers live for all the years, two phases each
+		WorkerPool pool(0);
+		cerr << "Running parallel Union Find on " << pool.size()
+		                                                << " threads" << endl;
+
+		// begin timer
+        start = std::chrono::system_clock::now(); 
+
+		// lock-free sets, merged by all the threads at once
+        ConcurrentUnionFind disjointSet(graph.size());
+		vector<pair<int,int>> merges;   // actor pairs to merge this year
+
+		int year = (*(tree.cbegin()))->movie_year;   // initial year
+		for (auto it = tree.cbegin(); it != tree.cend();){
+			// gather the merges of all movies in current year
+			merges.clear();
+			while ( year == (*it)->movie_year ){
+				vector<int>& actors = map[**it];
+				for (int i = 0; i < (int)actors.size() - 1; i++)
+					merges.push_back(make_pair(actors[i], actors[i+1]));
+				++it;
+				if (it == tree.cend())
+					break;
+			}
+
+			// the order of merges does not change the resulting sets
+			pool.parallelFor(merges.size(), [&](int i, int t){
+				disjointSet.merge(merges[i].first, merges[i].second);
+			}, MERGE_GRAIN);
+
+			// every pair of the tuple list is updated by one thread
+			pool.parallelFor(actorList.size(), [&](int i, int t){
+				auto & tuple = actorList[i];
+				if (year >= get<2>(tuple))
+					return;
+				if ( disjointSet.find(get<0>(tuple)) ==
+				                           disjointSet.find(get<1>(tuple)))
+					get<2>(tuple) = year;
+			}, MERGE_GRAIN);
+
+			year++;
+		}
+
+		// end timer
+	    end = std::chrono::system_clock::now();
+        std::chrono::duration<double> ms = end - start;
+        cerr << "The duration in seconds was " << ms.count() << endl;
+	}
+	else if (use_union){
 		cerr << "Running Union Find" << endl; 
 
 		// begin timer
@@ -195,9 +260,15 @@ int main(int argc, const char ** argv){
 	}
     
     // prints output to outfile
-	for (auto & tuple: actorList){
-		outfile << graph.actorSet[get<0>(tuple)]->actor_name << "\t" <<
-        graph.actorSet[get<1>(tuple)]->actor_name << "\t" << get<2>(tuple) <<
+	for (int i = 0; i < (int)actorList.size(); i++){
+		auto & tuple = actorList[i];
+		if (get<0>(tuple) < 0 || get<1>(tuple) < 0){
+			outfile << "Actor/actress (" << (get<0>(tuple) < 0 ?
+			       names[i].first : names[i].second) << ") not found!\n";
+			continue;
+		}
+		outfile << graph.nameOf(get<0>(tuple)) << "\t" <<
+        graph.nameOf(get<1>(tuple)) << "\t" << get<2>(tuple) <<
                                                                          "\n";
 	}
 
@@ -208,7 +279,10 @@ int main(int argc, const char ** argv){
     
     // closes streams
 	infile.close();
-	outfile.close();
+	if (!outfile.close()) {
+		cerr << "Failed to write " << out_filename << "!\n";
+		return -1;
+	}
 
 
 	return 0;
@@ -0,0 +1,304 @@
+/**
+ * Name: Haiyu Huang, Kyle Chang
+ * Date: November 29, 2016
+ * CSE 100 Fall 2016
+ * PA4: Graph Theory
+ * File: analytics.cpp
+ * Description: Whole-graph statistics over the actor graph, written as
+ *              tab separated tables.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "ActorGraph.h"
+#include "Betweenness.h"
+#include "DeltaStepping.h"
+#include "Separation.h"
+
+#define NUM_ARGS 4
+#define DEFAULT_TOP 100
+#define BOUND_FAILURE 0.05      // chance a sampled estimate exceeds its bound
+using namespace std;
+
+/**
+ * Prints how to run the program
+ */
+void usage(){
+	cerr << "Usage: analytics separation movie_casts.tsv out_prefix "
+	     << "[--top N] [--samples S] [--threads T] [--seed S]" << endl
+	     << "       analytics sssp movie_casts.tsv out_prefix "
+	     << "--source actor [--delta D] [--threads T] [--verify]" << endl
+	     << "       analytics betweenness movie_casts.tsv out_prefix "
+	     << "[--top K] [--samples S] [--threads T] [--seed S]" << endl;
+}
+
+/**
+ * Hop distance distribution, diameter and eccentricity of the N actors with
+ * the most co-stars. Writes out_prefix.hist.tsv, out_prefix.ecc.tsv and
+ * out_prefix.summary.tsv.
+ * Parameters:
+ *      graph: Loaded actor graph
+ *      prefix: Prefix of the output files
+ *      top: Number of actors to report eccentricities for
+ *      samples: BFS sources for the distribution, 0 for exact
+ *      threads: Worker threads, 0 for one per core
+ *      seed: Seed for the sampled distribution
+ *
+ */
+int separation(ActorGraph& graph, string prefix, int top, int samples,
+                                              int threads, unsigned seed){
+	Adjacency adjacency;
+	graph.buildAdjacency(adjacency, false);
+	SeparationAnalytics analytics(adjacency, threads);
+	int size = adjacency.size();
+
+	cerr << "Computing distance distribution" << endl;
+	long long unreachable = 0;
+	vector<long long> histogram =
+	           analytics.distanceDistribution(samples, seed, unreachable);
+
+	cerr << "Computing diameter" << endl;
+	int searches = 0;
+	int diameter = analytics.diameter(searches);
+
+	cerr << "Computing eccentricities" << endl;
+	vector<int> actors(size);
+	for (int actor = 0; actor < size; actor++)
+		actors[actor] = actor;
+	top = min(top, size);
+	partial_sort(actors.begin(), actors.begin() + top, actors.end(),
+	             [&adjacency](int lhs, int rhs){
+		if (adjacency.degree(lhs) != adjacency.degree(rhs))
+			return adjacency.degree(lhs) > adjacency.degree(rhs);
+		return lhs < rhs;
+	});
+	actors.resize(top);
+	vector<int> eccentricity = analytics.eccentricities(actors);
+
+	// distance distribution table
+	long long pairs = unreachable;
+	for (long long count : histogram)
+		pairs += count;
+	ofstream hist((prefix + ".hist.tsv").c_str());
+	hist << "Hops\tPairs\tFraction\n";
+	for (size_t hops = 1; hops < histogram.size(); hops++)
+		hist << hops << "\t" << histogram[hops] << "\t"
+		     << (double)histogram[hops] / pairs << "\n";
+	hist << "inf\t" << unreachable << "\t" << (double)unreachable / pairs
+	     << "\n";
+
+	// eccentricity table
+	ofstream ecc((prefix + ".ecc.tsv").c_str());
+	ecc << "Actor\tCostars\tEccentricity\n";
+	for (int k = 0; k < top; k++)
+		ecc << graph.nameOf(actors[k]) << "\t"
+		    << adjacency.degree(actors[k]) << "\t" << eccentricity[k] << "\n";
+
+	// summary table
+	ofstream summary((prefix + ".summary.tsv").c_str());
+	summary << "Statistic\tValue\n"
+	        << "actors\t" << size << "\n"
+	        << "costar_pairs\t" << adjacency.targets.size() / 2 << "\n"
+	        << "distribution_sources\t"
+	        << ((samples <= 0 || samples >= size) ? size : samples) << "\n"
+	        << "unreachable_pairs\t" << unreachable << "\n"
+	        << "diameter\t" << diameter << "\n"
+	        << "diameter_searches\t" << searches << "\n";
+	return 0;
+}
+
+/**
+ * Weighted distance from one actor to every actor with parallel delta
+ * stepping. Writes out_prefix.sssp.tsv with the distance and the previous
+ * actor on a shortest path for every actor reached.
+ * Parameters:
+ *      graph: Loaded actor graph
+ *      prefix: Prefix of the output file
+ *      source: Name of the actor to start from
+ *      delta: Bucket width, 0 to derive it from the weights
+ *      threads: Worker threads, 0 for one per core
+ *      verify: Compare the distances with ActorGraph::Dijkstra
+ *
+ */
+int sssp(ActorGraph& graph, string prefix, string source, int delta,
+                                                  int threads, bool verify){
+	int sourceIndex = graph.locateActor(source);
+	if (sourceIndex < 0){
+		cerr << "Unknown actor " << source << endl;
+		return -1;
+	}
+
+	Adjacency adjacency;
+	graph.buildAdjacency(adjacency, true);
+	DeltaStepping search(adjacency, threads, delta);
+
+	vector<int> dist;
+	vector<int> prev;
+	chrono::time_point<chrono::steady_clock> start, end;
+	start = chrono::steady_clock::now();
+	search.run(sourceIndex, dist, prev);
+	end = chrono::steady_clock::now();
+	chrono::duration<double> seconds = end - start;
+	cerr << "Delta stepping with width " << search.bucketWidth() << " took "
+	     << seconds.count() << " seconds" << endl;
+
+	ofstream outfile((prefix + ".sssp.tsv").c_str());
+	outfile << "Actor\tDistance\tPrevious\n";
+	for (int actor = 0; actor < adjacency.size(); actor++){
+		if (dist[actor] == INT_MAX)
+			continue;
+		outfile << graph.nameOf(actor) << "\t" << dist[actor]
+		        << "\t";
+		if (prev[actor] != -1)
+			outfile << graph.nameOf(prev[actor]);
+		outfile << "\n";
+	}
+
+	if (verify){
+		graph.Dijkstra(sourceIndex, -1);
+		int mismatches = 0;
+		for (int actor = 0; actor < adjacency.size(); actor++){
+			if (graph.distanceTo(actor) != dist[actor])
+				mismatches++;
+		}
+		cerr << "Distances differing from Dijkstra: " << mismatches << endl;
+		if (mismatches)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Betweenness centrality of every actor, exact or estimated from sampled
+ * sources. Writes the K highest to out_prefix.betweenness.tsv and the
+ * sampling and timing to out_prefix.betweenness.summary.tsv.
+ * Parameters:
+ *      graph: Loaded actor graph
+ *      prefix: Prefix of the output files
+ *      top: Number of actors to report
+ *      samples: BFS sources, 0 for exact
+ *      threads: Worker threads, 0 for one per core
+ *      seed: Seed for picking the sources
+ *
+ */
+int betweenness(ActorGraph& graph, string prefix, int top, int samples,
+                                                int threads, unsigned seed){
+	Adjacency adjacency;
+	graph.buildAdjacency(adjacency, false);
+	BetweennessCentrality centrality(adjacency, threads);
+	int size = adjacency.size();
+	bool exact = samples <= 0 || samples >= size;
+
+	cerr << "Computing betweenness from "
+	     << (exact ? size : samples) << " sources" << endl;
+	chrono::time_point<chrono::steady_clock> start, end;
+	start = chrono::steady_clock::now();
+	vector<double> score;
+	vector<double> stdError(size, 0);
+	if (exact)
+		score = centrality.exact();
+	else
+		score = centrality.sampled(samples, seed, stdError);
+	end = chrono::steady_clock::now();
+	chrono::duration<double> seconds = end - start;
+
+	vector<int> actors(size);
+	for (int actor = 0; actor < size; actor++)
+		actors[actor] = actor;
+	top = min(top, size);
+	partial_sort(actors.begin(), actors.begin() + top, actors.end(),
+	             [&score](int lhs, int rhs){
+		if (score[lhs] != score[rhs])
+			return score[lhs] > score[rhs];
+		return lhs < rhs;
+	});
+
+	// betweenness over the pairs of other actors, for the normalized column
+	double pairs = size > 2 ? (double)(size - 1) * (size - 2) / 2 : 1;
+	ofstream table((prefix + ".betweenness.tsv").c_str());
+	table.precision(10);
+	table << "Actor\tCostars\tBetweenness\tNormalized\tStdError\n";
+	for (int k = 0; k < top; k++)
+		table << graph.nameOf(actors[k]) << "\t"
+		      << adjacency.degree(actors[k]) << "\t" << score[actors[k]]
+		      << "\t" << score[actors[k]] / pairs << "\t"
+		      << stdError[actors[k]] << "\n";
+
+	ofstream summary((prefix + ".betweenness.summary.tsv").c_str());
+	summary << "Statistic\tValue\n"
+	        << "actors\t" << size << "\n"
+	        << "costar_pairs\t" << adjacency.targets.size() / 2 << "\n"
+	        << "sources\t" << (exact ? size : samples) << "\n"
+	        << "exact\t" << (exact ? 1 : 0) << "\n"
+	        << "error_bound\t" << (exact ? 0 :
+	           BetweennessCentrality::errorBound(size, samples, BOUND_FAILURE))
+	        << "\n"
+	        << "bound_failure\t" << (exact ? 0 : BOUND_FAILURE) << "\n"
+	        << "seconds\t" << seconds.count() << "\n";
+	return 0;
+}
+
+int main(int argc, const char ** argv){
+	// Checks for valid number of inputs
+	if (argc < NUM_ARGS) {
+		usage();
+		return -1;
+	}
+
+	const char * mode = argv[1];
+	const char * movie_casts = argv[2];
+	string prefix(argv[3]);
+
+	int top = DEFAULT_TOP;      // actors to report
+	int samples = 0;            // BFS sources, 0 for exact
+	int threads = 0;            // worker threads, 0 for one per core
+	unsigned seed = 1;          // seed for sampling
+	string source;              // source actor of sssp
+	int delta = 0;              // bucket width of sssp, 0 to derive it
+	bool verify = false;        // check sssp against Dijkstra
+
+	// optional arguments following the required ones
+	for (int i = NUM_ARGS; i < argc; i++) {
+		if (!strcmp(argv[i], "--top") && i + 1 < argc)
+			top = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--samples") && i + 1 < argc)
+			samples = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+			seed = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--source") && i + 1 < argc)
+			source = argv[++i];
+		else if (!strcmp(argv[i], "--delta") && i + 1 < argc)
+			delta = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--verify"))
+			verify = true;
+		else {
+			cerr << "Unknown option " << argv[i] << endl;
+			return -1;
+		}
+	}
+
+	if (strcmp(mode, "separation") && strcmp(mode, "sssp") &&
+	                                      strcmp(mode, "betweenness")) {
+		usage();
+		return -1;
+	}
+
+	ActorGraph graph;                           // graph
+	unordered_map<Movie, vector <int>> map;     // maps movie to its actors
+	if (!graph.loadFromFile(movie_casts, map))
+		return -1;
+	graph.createGraph(map);
+
+	if (!strcmp(mode, "sssp"))
+		return sssp(graph, prefix, source, delta, threads, verify);
+	if (!strcmp(mode, "betweenness"))
+		return betweenness(graph, prefix, top, samples, threads, seed);
+	return separation(graph, prefix, top, samples, threads, seed);
+}
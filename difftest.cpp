@@ -0,0 +1,474 @@
+/**
+ * Name: Haiyu Huang, Kyle Chang
+ * Date: December 10, 2016
+ * CSE 100 Fall 2016
+ * PA4: Graph Theory
+ * File: difftest.cpp
+ * Description: Runs our pathfinder and actorconnections side by side with
+ *              the reference builds on generated casts of growing size,
+ *              checks every answer and reports wall time and peak memory.
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DEFAULT_PAIRS 100
+#define MIN_YEAR 1950           // years of the generated movies
+#define MAX_YEAR 2015
+#define WEIGHT_YEAR 2016        // an edge weighs WEIGHT_YEAR - year
+using namespace std;
+
+/**
+ * Outcome of one run of a program
+ */
+struct RunResult{
+    bool ran;           // the program started and exited with status 0
+    double seconds;     // wall time from fork to exit
+    long maxRSS;        // peak resident memory in KB
+};
+
+/**
+ * Runs a program with its output streams sent to /dev/null and waits for
+ * it, reading its peak memory from the rusage of wait4
+ * Parameters:
+ *      args: Path of the program followed by its arguments
+ *
+ * Return: Whether it ran, its wall time and its peak memory
+ */
+RunResult runProgram(const vector<string>& args){
+    RunResult result = { false, 0, 0 };
+    vector<char *> argv;
+    for (const string& arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(NULL);
+
+    chrono::time_point<chrono::steady_clock> start = chrono::steady_clock::now();
+    pid_t child = fork();
+    if (child < 0)
+        return result;
+    if (child == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) != child)
+        return result;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    result.ran = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.seconds = elapsed.count();
+    result.maxRSS = usage.ru_maxrss;
+    return result;
+}
+
+/**
+ * Makes a program runnable. The reference builds are checked in without
+ * the exec bit, so a copy with the bit set is made in the work directory.
+ * Parameters:
+ *      path: Program to run
+ *      work: Directory for the copy
+ *
+ * Return: Path of a runnable program, the original if it already was
+ */
+string runnable(const string& path, const string& work){
+    if (access(path.c_str(), X_OK) == 0)
+        return path;
+    string copy = work + "/" + path.substr(path.find_last_of('/') + 1);
+    ifstream source(path.c_str(), ios::binary);
+    ofstream target(copy.c_str(), ios::binary);
+    target << source.rdbuf();
+    target.close();
+    chmod(copy.c_str(), 0755);
+    return copy;
+}
+
+/**
+ * Writes a random cast file. Movies come one after the other; the first
+ * member of each is an actor cast before, so the graph stays connected,
+ * then the next actor not cast yet, then actors picked with a bias towards
+ * low indices so a few actors are in many movies. The lines are grouped
+ * by actor as loadFromFile expects.
+ * Parameters:
+ *      filename: File to write
+ *      actors: Number of actors
+ *      random: Random generator
+ *
+ */
+void generateCasts(const string& filename, int actors, mt19937& random){
+    vector<vector<pair<int,int>>> roles(actors); // movie and year by actor
+    uniform_int_distribution<int> castSize(2, 12);
+    uniform_int_distribution<int> year(MIN_YEAR, MAX_YEAR);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    int cast = 1;       // actors cast so far, actor 0 starts out cast
+    int movies = max(actors / 2, 1);
+    for (int movie = 0; movie < movies || cast < actors; movie++) {
+        int released = year(random);
+        vector<int> members(1, (int)(unit(random) * cast));
+        if (cast < actors)
+            members.push_back(cast++);
+        int size = castSize(random);
+        for (int tries = 0; (int)members.size() < size && tries < 4 * size;
+                                                                    tries++) {
+            int actor = (int)(cast * unit(random) * unit(random));
+            bool seen = false;
+            for (int member : members)
+                seen = seen || member == actor;
+            if (!seen)
+                members.push_back(actor);
+        }
+        for (int member : members)
+            roles[member].push_back(make_pair(movie, released));
+    }
+
+    ofstream out(filename.c_str());
+    out << "Actor/Actress\tMovie\tYear\n";
+    for (int actor = 0; actor < actors; actor++)
+        for (auto & role : roles[actor])
+            out << "Actor " << actor << "\tMovie " << role.first << "\t"
+                << role.second << "\n";
+}
+
+/**
+ * Writes random query pairs of distinct actors
+ * Parameters:
+ *      filename: File to write
+ *      actors: Number of actors to pick from
+ *      count: Number of pairs
+ *      random: Random generator
+ *
+ */
+void generatePairs(const string& filename, int actors, int count,
+                                                        mt19937& random){
+    uniform_int_distribution<int> pick(0, actors - 1);
+    ofstream out(filename.c_str());
+    out << "Actor1/Actress1\tActor2/Actress2\n";
+    for (int q = 0; q < count; q++) {
+        int from = pick(random);
+        int to = pick(random);
+        if (to == from)
+            to = (to + 1) % actors;
+        out << "Actor " << from << "\tActor " << to << "\n";
+    }
+}
+
+/**
+ * Reads the lines of a file after its header
+ * Parameters:
+ *      filename: File to read
+ *      lines: Set to the lines
+ *
+ */
+void readLines(const string& filename, vector<string>& lines){
+    ifstream in(filename.c_str());
+    string line;
+    lines.clear();
+    bool header = false;
+    while (getline(in, line)) {
+        if (header)
+            lines.push_back(line);
+        header = true;
+    }
+}
+
+/**
+ * Every actor, movie, year triple of a cast file, to check paths against
+ */
+class CastIndex {
+    unordered_set<string> roles;    // "actor\tmovie\tyear" of every line
+
+public:
+    /**
+     * Reads a cast file
+     * Parameters:
+     *      filename: File to read
+     *
+     */
+    void load(const string& filename){
+        vector<string> lines;
+        readLines(filename, lines);
+        roles.clear();
+        roles.insert(lines.begin(), lines.end());
+    }
+
+    /**
+     * Whether an actor played in a movie
+     * Parameters:
+     *      actor: Name of the actor
+     *      movie: "title#@year" as pathfinder prints it
+     *      year: Set to the year of the movie
+     *
+     * Return: true if the cast file has the role, false otherwise
+     */
+    bool plays(const string& actor, const string& movie, int& year) const {
+        size_t at = movie.rfind("#@");
+        if (at == string::npos)
+            return false;
+        year = atoi(movie.c_str() + at + 2);
+        return roles.count(actor + "\t" + movie.substr(0, at) + "\t" +
+                                                movie.substr(at + 2)) > 0;
+    }
+};
+
+/**
+ * Checks one line of pathfinder output: it has to start and end at the
+ * query actors and every movie has to link the actors on its two sides
+ * Parameters:
+ *      line: Line to check
+ *      from: Name of the first actor of the query
+ *      to: Name of the second actor of the query
+ *      casts: Roles of the cast file
+ *      weighted: Add up WEIGHT_YEAR - year instead of hops
+ *      cost: Set to the cost of the path
+ *
+ * Return: true if the path is valid, false otherwise
+ */
+bool checkPath(const string& line, const string& from, const string& to,
+               const CastIndex& casts, bool weighted, long& cost){
+    cost = 0;
+    if (line.size() < 2 || line[0] != '(' || line.back() != ')')
+        return false;
+
+    size_t pos = 1;
+    string actor;
+    size_t close = line.find(")--[", pos);
+    actor = line.substr(pos, (close == string::npos ? line.size() - 1 : close)
+                                                                      - pos);
+    if (actor != from)
+        return false;
+    while (close != string::npos) {
+        size_t arrow = line.find("]-->(", close);
+        if (arrow == string::npos)
+            return false;
+        string movie = line.substr(close + 4, arrow - close - 4);
+        pos = arrow + 5;
+        close = line.find(")--[", pos);
+        string next = line.substr(pos,
+                  (close == string::npos ? line.size() - 1 : close) - pos);
+        int year;
+        if (!casts.plays(actor, movie, year) || !casts.plays(next, movie, year))
+            return false;
+        cost += weighted ? WEIGHT_YEAR - year : 1;
+        actor = next;
+    }
+    return actor == to;
+}
+
+/**
+ * Counts the answers of pathfinder outputs that are invalid or cost more
+ * than the other side's. Equal cost paths through other actors are fine.
+ * Without a reference output only ours is checked.
+ * Parameters:
+ *      pairs: Pairs file of the queries
+ *      casts: Roles of the cast file
+ *      weighted: Paths were weighted
+ *      ours: Our output
+ *      reference: Reference output, empty if it did not run
+ *
+ * Return: Number of bad answers on either side
+ */
+int comparePaths(const vector<string>& pairs, const CastIndex& casts,
+                 bool weighted, const string& ours, const string& reference){
+    vector<string> ourLines, refLines;
+    readLines(ours, ourLines);
+    if (!reference.empty())
+        readLines(reference, refLines);
+
+    int bad = 0;
+    for (size_t q = 0; q < pairs.size(); q++) {
+        size_t tab = pairs[q].find('\t');
+        string from = pairs[q].substr(0, tab);
+        string to = pairs[q].substr(tab + 1);
+
+        long ourCost, refCost;
+        bool ourValid = q < ourLines.size() &&
+                  checkPath(ourLines[q], from, to, casts, weighted, ourCost);
+        if (reference.empty()) {
+            bad += !ourValid;
+            continue;
+        }
+        bool refValid = q < refLines.size() &&
+                  checkPath(refLines[q], from, to, casts, weighted, refCost);
+        if (!ourValid || !refValid || ourCost != refCost)
+            bad++;
+    }
+    return bad;
+}
+
+/**
+ * Counts the lines of two actorconnections outputs that differ. The year
+ * two actors become connected has one right answer, so lines must match.
+ * Parameters:
+ *      ours: Our output
+ *      reference: Reference output
+ *
+ * Return: Number of differing lines
+ */
+int compareLines(const string& ours, const string& reference){
+    vector<string> ourLines, refLines;
+    readLines(ours, ourLines);
+    readLines(reference, refLines);
+    int bad = 0;
+    for (size_t i = 0; i < max(ourLines.size(), refLines.size()); i++)
+        bad += i >= ourLines.size() || i >= refLines.size() ||
+                                               ourLines[i] != refLines[i];
+    return bad;
+}
+
+/**
+ * Prints one row of the scoreboard
+ * Parameters:
+ *      actors: Scale of the run
+ *      test: Program and mode
+ *      ours: Our run
+ *      reference: Reference run
+ *      checked: Answers checked
+ *      bad: Answers that failed, -1 if nothing could be checked
+ *
+ */
+void printRow(int actors, const string& test, const RunResult& ours,
+              const RunResult& reference, int checked, int bad){
+    cout << left << setw(10) << actors << setw(22) << test << right << fixed
+         << setprecision(3);
+    if (ours.ran)
+        cout << setw(10) << ours.seconds;
+    else
+        cout << setw(10) << "failed";
+    if (reference.ran)
+        cout << setw(10) << reference.seconds;
+    else
+        cout << setw(10) << "n/a";
+    if (ours.ran && reference.ran && ours.seconds > 0)
+        cout << setw(9) << setprecision(2) << reference.seconds / ours.seconds
+             << "x";
+    else
+        cout << setw(10) << "n/a";
+    cout << setw(10) << setprecision(1) << ours.maxRSS / 1024.0;
+    if (reference.ran)
+        cout << setw(10) << reference.maxRSS / 1024.0;
+    else
+        cout << setw(10) << "n/a";
+    cout << setw(9) << checked;
+    if (bad < 0)
+        cout << setw(6) << "n/a";
+    else
+        cout << setw(6) << bad;
+    cout << "\n";
+}
+
+int main(int argc, const char ** argv){
+    string oursDir = ".";             // directory of our builds
+    string refDir = ".";              // directory of the reference builds
+    string work = "/tmp/difftest";    // generated files and outputs
+    vector<int> scales = { 1000, 10000, 100000 }; // actors of each run
+    int numPairs = DEFAULT_PAIRS;     // queries of each run
+    unsigned seed = 1;                // seed of the generated files
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ours") && i + 1 < argc)
+            oursDir = argv[++i];
+        else if (!strcmp(argv[i], "--reference") && i + 1 < argc)
+            refDir = argv[++i];
+        else if (!strcmp(argv[i], "--work") && i + 1 < argc)
+            work = argv[++i];
+        else if (!strcmp(argv[i], "--pairs") && i + 1 < argc)
+            numPairs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--scales") && i + 1 < argc) {
+            scales.clear();
+            stringstream list(argv[++i]);
+            string scale;
+            while (getline(list, scale, ','))
+                scales.push_back(atoi(scale.c_str()));
+        }
+        else {
+            cerr << "Usage: difftest [--ours DIR] [--reference DIR] "
+                    "[--work DIR] [--scales N,N,...] [--pairs N] [--seed S]"
+                 << endl;
+            return -1;
+        }
+    }
+    for (int scale : scales) {
+        if (scale < 2) {
+            cerr << "Every scale needs at least 2 actors" << endl;
+            return -1;
+        }
+    }
+
+    mkdir(work.c_str(), 0755);
+    string ourPathfinder = oursDir + "/pathfinder";
+    string ourConnections = oursDir + "/actorconnections";
+    string refPathfinder = runnable(refDir + "/refpathfinder", work);
+    string refConnections = runnable(refDir + "/refactorconnections", work);
+
+    cout << left << setw(10) << "actors" << setw(22) << "test" << right
+         << setw(10) << "ours(s)" << setw(10) << "ref(s)" << setw(10)
+         << "speedup" << setw(10) << "ours(MB)" << setw(10) << "ref(MB)"
+         << setw(9) << "checked" << setw(6) << "bad" << "\n";
+
+    mt19937 random(seed);
+    int failures = 0;
+    for (int actors : scales) {
+        string prefix = work + "/" + to_string(actors);
+        string castFile = prefix + "_casts.tsv";
+        string pairFile = prefix + "_pairs.tsv";
+        generateCasts(castFile, actors, random);
+        generatePairs(pairFile, actors, numPairs, random);
+
+        CastIndex casts;
+        casts.load(castFile);
+        vector<string> pairs;
+        readLines(pairFile, pairs);
+
+        // pathfinder, both edge weights
+        for (const char * mode : { "u", "w" }) {
+            string ourOut = prefix + "_ours_" + mode + ".txt";
+            string refOut = prefix + "_ref_" + mode + ".txt";
+            RunResult ours = runProgram({ ourPathfinder, castFile, mode,
+                                          pairFile, ourOut });
+            RunResult ref = runProgram({ refPathfinder, castFile, mode,
+                                         pairFile, refOut });
+            int bad = comparePaths(pairs, casts, !strcmp(mode, "w"), ourOut,
+                                   ref.ran ? refOut : string());
+            failures += bad + !ours.ran;
+            printRow(actors, string("pathfinder ") + mode, ours, ref,
+                     pairs.size(), bad);
+        }
+
+        // actorconnections, both algorithms
+        for (const char * algorithm : { "bfs", "ufind" }) {
+            string ourOut = prefix + "_ours_" + algorithm + ".txt";
+            string refOut = prefix + "_ref_" + algorithm + ".txt";
+            RunResult ours = runProgram({ ourConnections, castFile, pairFile,
+                                          ourOut, algorithm });
+            RunResult ref = runProgram({ refConnections, castFile, pairFile,
+                                         refOut, algorithm });
+            int bad = (ours.ran && ref.ran) ? compareLines(ourOut, refOut) : -1;
+            failures += max(bad, 0) + !ours.ran;
+            printRow(actors, string("actorconnections ") + algorithm, ours,
+                     ref, pairs.size(), bad);
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -8,15 +8,218 @@
  *
  */ 
 
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include "EdgeList.h"
 #include "Graph.h"
+#include "IncrementalSCC.h"
 
 #define NUM_ARGS 3
+#define DEFAULT_INTERVAL 10000
+#define REPORT_LARGEST 10
+#define LABELS_MAGIC 0x43435352    // "RSCC"
+#define DAG_MAGIC 0x47414452       // "RDAG"
+#define OUTPUT_VERSION 1
 using namespace std;
 
+/**
+ * Writes every component on one line, largest first and in the order they
+ * were found on ties, as the user ids of its members in the order the
+ * search visited them. Components and members are grouped by counting
+ * sorts over the label array, which keep both orders.
+ * Parameters:
+ *      out: Stream to write to
+ *      edges: Edges the components were found in
+ *      component: Component id of every user
+ *      order: Every user in the order the search visited them
+ *      count: Number of components
+ *
+ */
+void writeList(ostream& out, const EdgeList& edges,
+               const vector<int>& component, const vector<int>& order,
+                                                                  int count){
+    int users = component.size();
+
+    // members of each component, grouped by component id
+    vector<int> start(count + 1, 0);
+    for (int comp : component)
+        start[comp + 1]++;
+    vector<int> size(count);
+    for (int comp = 0; comp < count; comp++) {
+        size[comp] = start[comp + 1];
+        start[comp + 1] += start[comp];
+    }
+    vector<int> members(users);
+    vector<int> next(start.begin(), start.end() - 1);
+    for (int user : order)
+        members[next[component[user]]++] = user;
+
+    // components by decreasing size, in the order they were found on ties
+    vector<int> bySize(users + 2, 0);
+    for (int comp = 0; comp < count; comp++)
+        bySize[users - size[comp] + 1]++;
+    for (int k = 0; k <= users; k++)
+        bySize[k + 1] += bySize[k];
+    vector<int> ordered(count);
+    for (int comp = 0; comp < count; comp++)
+        ordered[bySize[users - size[comp]]++] = comp;
+
+    for (int comp : ordered) {
+        for (int k = start[comp]; k < start[comp + 1]; k++)
+            out << edges.userID[members[k]] << " ";
+        out << "\n";
+    }
+}
+
+/**
+ * Writes the component of every user, as "user component" lines or as a
+ * binary file: magic, version, number of users, number of components, the
+ * user ids and the component ids as raw ints
+ * Parameters:
+ *      out: Stream to write to
+ *      edges: Edges the components were found in
+ *      component: Component id of every user
+ *      count: Number of components
+ *      binary: Write the binary form
+ *
+ */
+void writeLabels(ostream& out, const EdgeList& edges,
+                      const vector<int>& component, int count, bool binary){
+    if (!binary) {
+        for (size_t user = 0; user < component.size(); user++)
+            out << edges.userID[user] << " " << component[user] << "\n";
+        return;
+    }
+    uint32_t header[2] = { LABELS_MAGIC, OUTPUT_VERSION };
+    int64_t sizes[2] = { (int64_t)component.size(), count };
+    out.write((const char *)header, sizeof(header));
+    out.write((const char *)sizes, sizeof(sizes));
+    out.write((const char *)edges.userID.data(),
+                                            sizeof(int) * edges.userID.size());
+    out.write((const char *)component.data(), sizeof(int) * component.size());
+}
+
+/**
+ * Writes the condensation DAG, as "component component" lines or as a
+ * binary file: magic, version, number of components, number of edges, the
+ * offsets and the targets of the Adjacency as raw ints
+ * Parameters:
+ *      out: Stream to write to
+ *      dag: Edges between components
+ *      binary: Write the binary form
+ *
+ */
+void writeCondensation(ostream& out, const Adjacency& dag, bool binary){
+    if (!binary) {
+        for (int comp = 0; comp < dag.size(); comp++) {
+            for (int k = dag.offsets[comp]; k < dag.offsets[comp + 1]; k++)
+                out << comp << " " << dag.targets[k] << "\n";
+        }
+        return;
+    }
+    uint32_t header[2] = { DAG_MAGIC, OUTPUT_VERSION };
+    int64_t sizes[2] = { dag.size(), (int64_t)dag.targets.size() };
+    out.write((const char *)header, sizeof(header));
+    out.write((const char *)sizes, sizeof(sizes));
+    out.write((const char *)dag.offsets.data(),
+                                            sizeof(int) * dag.offsets.size());
+    out.write((const char *)dag.targets.data(),
+                                            sizeof(int) * dag.targets.size());
+}
+
+/**
+ * Writes how many components have each size, as "size count" lines
+ * Parameters:
+ *      out: Stream to write to
+ *      component: Component id of every user
+ *      count: Number of components
+ *
+ */
+void writeHistogram(ostream& out, const vector<int>& component, int count){
+    vector<int> size(count, 0);
+    for (int comp : component)
+        size[comp]++;
+    vector<long> histogram(component.size() + 1, 0);
+    for (int members : size)
+        histogram[members]++;
+    out << "Size\tComponents\n";
+    for (size_t members = 1; members < histogram.size(); members++) {
+        if (histogram[members])
+            out << members << "\t" << histogram[members] << "\n";
+    }
+}
+
+/**
+ * Streaming mode: reads retweet edges one line at a time, keeps the
+ * strongly connected components up to date and writes a line of component
+ * statistics every interval edges and once at the end.
+ * Parameters:
+ *      dataSource: File to read edges from, "-" for standard input
+ *      out_filename: File to write the statistics to
+ *      interval: Number of edges between two reports
+ *      follow: Keep waiting for more edges at the end of the input
+ *
+ * Return: 0 on success, -1 if the input could not be read
+ */
+int streamComponents(const char * dataSource, const char * out_filename,
+                                               long interval, bool follow){
+    ifstream infile;
+    istream * input = &cin;
+    if (strcmp(dataSource, "-")) {
+        infile.open(dataSource);
+        if (!infile) {
+            cerr << "Failed to read " << dataSource << "!\n";
+            return -1;
+        }
+        input = &infile;
+    }
+    ofstream outfile(out_filename);
+
+    IncrementalSCC scc;       // components of the edges read so far
+    string pending;           // line read so far, may lack its newline
+    long count = 0;           // edges added
+
+    while (true) {
+        string line;
+        bool complete = getline(*input, line) && !input->eof();
+        pending += line;
+
+        // a line without its newline may still be being written
+        if (!complete && follow) {
+            input->clear();
+            this_thread::sleep_for(chrono::seconds(1));
+            continue;
+        }
+
+        istringstream ss(pending);
+        int first;
+        int second;
+        if (ss >> first >> second) {
+            scc.addEdge(first, second);
+            count++;
+            if (count % interval == 0) {
+                scc.report(outfile, REPORT_LARGEST);
+                outfile.flush();
+            }
+        }
+        pending.clear();
+
+        if (!complete)
+            break;
+    }
+
+    scc.report(outfile, REPORT_LARGEST);
+    outfile.close();
+    return 0;
+}
+
 
 int main(int argc, const char ** argv){
     // input parameters
@@ -24,94 +227,119 @@ int main(int argc, const char ** argv){
     const char * out_filename = argv[2];
     
     // Checks for valid number of inputs
-    if (argc != NUM_ARGS) {
+    if (argc < NUM_ARGS) {
         cerr << "Wrong number of inputs into extension" << endl;
     return -1;
 
     }
 
-    Graph graph;                      // the graph data structure
-    vector<pair<int,int>> dataSet;    // data of retweets
+    bool stream = false;                 // incremental streaming mode
+    bool follow = false;                 // wait for more edges at the end
+    long interval = DEFAULT_INTERVAL;    // edges between stream reports
+    int threads = 0;                     // parser threads, 0 for one per core
+    const char * cache = NULL;           // binary edge cache, if any
+    const char * format = "list";        // list, labels or binary
+    const char * dag_filename = NULL;    // condensation DAG output, if any
+    const char * hist_filename = NULL;   // size histogram output, if any
 
-    
-    // Initialize the file stream
-    ifstream infile(dataSource);
-    ofstream outfile(out_filename);
-
-
-    // keep reading lines until the end of file is reached
-    while (infile) {
-        int first;
-
-        infile >> first;
-         
-        int second;
-        
-        infile >> second;
-		if (infile.eof()) break;
-
-        // stores inputs 
-        dataSet.push_back(make_pair(first, second));
+    // optional arguments following the two required ones
+    for (int i = NUM_ARGS; i < argc; i++) {
+        if (!strcmp(argv[i], "--stream"))
+            stream = true;
+        else if (!strcmp(argv[i], "--follow"))
+            follow = true;
+        else if (!strcmp(argv[i], "--interval") && i + 1 < argc)
+            interval = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cache") && i + 1 < argc)
+            cache = argv[++i];
+        else if (!strcmp(argv[i], "--format") && i + 1 < argc)
+            format = argv[++i];
+        else if (!strcmp(argv[i], "--dag") && i + 1 < argc)
+            dag_filename = argv[++i];
+        else if (!strcmp(argv[i], "--histogram") && i + 1 < argc)
+            hist_filename = argv[++i];
+        else {
+            cerr << "Unknown option " << argv[i] << endl;
+            return -1;
+        }
     }
+    if (interval <= 0)
+        interval = DEFAULT_INTERVAL;
+    if (strcmp(format, "list") && strcmp(format, "labels") &&
+                                                   strcmp(format, "binary")) {
+        cerr << "Unknown format " << format << endl;
+        return -1;
+    }
+    bool binary = !strcmp(format, "binary");
 
-    // create the node set
-    for (auto & pair : dataSet){
-        if ( !(graph.nodeSet[pair.first]) )
-           graph.nodeSet[pair.first] = new Node (pair.first); 
-
-        if ( !(graph.nodeSet[pair.second]) )
-           graph.nodeSet[pair.second] = new Node (pair.second); 
+    if (stream)
+        return streamComponents(dataSource, out_filename, interval, follow);
 
+    // binary edge cache, loaded instead of the text file it was made from
+    EdgeList edges(threads);
+    if (!cache || !edges.loadCache(cache, dataSource)) {
+        if (!edges.loadText(dataSource)) {
+            cerr << "Failed to read " << dataSource << "!\n";
+            return -1;
+        }
+        if (cache && !edges.saveCache(cache, dataSource))
+            cerr << "Failed to write " << cache << "!\n";
     }
-    
 
-	
-	
+    Graph graph;                      // the graph data structure
+
+    // create the node set
+    graph.createNodes(edges.size());
 
     // connect the edges
-	graph.createGraph(dataSet);
+	graph.createGraph(edges);
 
 
-	// initialize a stack of vertices
+	// initialize a stack of vertices, in the order a hash map of the user
+	// ids filled edge by edge iterates, which fixes the order components
+	// are found and listed in
 	stack<int> vertices;
-	for (auto & pair: graph.nodeSet)
-		vertices.push(pair.first);
+	unordered_map<int, int> seen;       // dense index of every user id
+	for (size_t k = 0; k < edges.tails.size(); k++) {
+		seen.emplace(edges.userID[edges.tails[k]], edges.tails[k]);
+		seen.emplace(edges.userID[edges.heads[k]], edges.heads[k]);
+	}
+	for (auto & user : seen)
+		vertices.push(user.second);
 
 	// DFS on the original graph
 	stack<int> finished = graph.DFSTraversal(vertices);
 
 
-	
+	// the transposed graph reuses the nodes
 	graph.clearGraph();
-	Graph transpose(graph);		// the transposed graph
-	transpose.createTransposeGraph(dataSet);
+	graph.createTransposeGraph(edges);
 
-	auto tree = transpose.DFSTraversalSCC(finished); //find SCC in transpose
+	vector<int> component;      // component id of every user
+	vector<int> order;          // users in the order the search found them
+	int count = graph.DFSTraversalSCC(finished, component, order); //SCC
+	                                                          // in transpose
     
     // prints to outfile
-	for (const vector<int>& vector: tree){
-		for (int num : vector)
-			outfile << num << " ";
-		outfile << "\n";
-	}
-
-	// run algorithm to generate the strongly connected component
-    
-
-
-    if (!infile.eof()) {
-        cerr << "Failed to read " << dataSource << "!\n";
-        return false;
-    }
-    
-    // closes streams 
-    infile.close();
+    ofstream outfile(out_filename, binary ? ios::binary : ios::out);
+    if (!strcmp(format, "list"))
+        writeList(outfile, edges, component, order, count);
+    else
+        writeLabels(outfile, edges, component, count, binary);
     outfile.close();
 
-	// setting pointer to null to prevent double deletion
-	for (auto& pair : transpose.nodeSet)
-		pair.second = NULL;
-
+    if (dag_filename) {
+        Adjacency dag;
+        graph.condensation(edges, component, count, dag);
+        ofstream dagfile(dag_filename, binary ? ios::binary : ios::out);
+        writeCondensation(dagfile, dag, binary);
+    }
+    if (hist_filename) {
+        ofstream histfile(hist_filename);
+        writeHistogram(histfile, component, count);
+    }
 
     return 0;
 
@@ -0,0 +1,383 @@
+/**
+ * Name: Haiyu Huang, Kyle Chang
+ * Date: November 27, 2016
+ * CSE 100 Fall 2016
+ * PA4: Graph Theory
+ * File: graphbench.cpp
+ * Description: Benchmarks the actor graph traversals under the different
+ *              vertex orderings, reporting wall time and cache misses.
+ *              Top-down BFS runs both one query after the other and in
+ *              interleaved batches on the same core. With --unionfind it
+ *              times every disjoint set policy on the merges of the data.
+ *
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include "ActorGraph.h"
+#include "SearchEngine.hpp"
+#include "UnionFind.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define NUM_ARGS 2
+#define DEFAULT_QUERIES 200
+#define BATCH_SIZE 16           // searches interleaved by the batch rows
+using namespace std;
+
+/**
+ * Counts last level cache misses of this process through perf_event_open.
+ * When the counter is not available (no permission, not Linux) every
+ * reading is -1.
+ */
+class MissCounter {
+	int fd;     // file descriptor of the hardware counter
+
+public:
+    /**
+     * Opens the hardware counter, disabled until start is called
+     */
+	MissCounter() : fd(-1) {
+#ifdef __linux__
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+    /**
+     * Closes the hardware counter
+     */
+	~MissCounter() {
+#ifdef __linux__
+		if (fd >= 0)
+			close(fd);
+#endif
+	}
+
+    /**
+     * Resets the counter and starts counting
+     */
+	void start() {
+#ifdef __linux__
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+    /**
+     * Stops counting
+     *
+     * Return: Number of cache misses since start, -1 if unavailable
+     */
+	long long stop() {
+		long long count = -1;
+#ifdef __linux__
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd, &count, sizeof(count)) != sizeof(count))
+				count = -1;
+		}
+#endif
+		return count;
+	}
+};
+
+/**
+ * Runs every query pair with either BFS or Dijkstra and prints one row of
+ * the result table.
+ * Parameters:
+ *      graph: Graph to traverse
+ *      queries: Pairs of actor indices
+ *      label: Name of the ordering
+ *      weighted: Use Dijkstra or BFS
+ *
+ */
+void runQueries(ActorGraph& graph, vector<pair<int,int>>& queries,
+                                        const char * label, bool weighted) {
+	MissCounter counter;
+	chrono::time_point<chrono::steady_clock> start, end;
+
+	counter.start();
+	start = chrono::steady_clock::now();
+	for (auto & query : queries) {
+		if (weighted)
+			graph.Dijkstra(query.first, query.second);
+		else
+			graph.BFSTraversal(query.first, query.second);
+	}
+	end = chrono::steady_clock::now();
+	long long misses = counter.stop();
+
+	chrono::duration<double> seconds = end - start;
+	cout << left << setw(8) << label << setw(10)
+	     << (weighted ? "dijkstra" : "bfs") << right << setw(12)
+	     << fixed << setprecision(4) << seconds.count() << setw(16);
+	if (misses < 0)
+		cout << "n/a";
+	else
+		cout << misses;
+	cout << "\n";
+}
+
+/**
+ * Runs every query pair with a top-down BFS, either one after the other
+ * or BATCH_SIZE at a time interleaved by BFSBatch, and prints one row of
+ * the result table. Both find the same paths.
+ * Parameters:
+ *      graph: Graph to traverse
+ *      queries: Pairs of actor indices
+ *      label: Name of the ordering
+ *      batched: Interleave the searches
+ *
+ */
+void runTopDown(ActorGraph& graph, vector<pair<int,int>>& queries,
+                                        const char * label, bool batched) {
+	MissCounter counter;
+	chrono::time_point<chrono::steady_clock> start, end;
+	vector<SearchState> states(BATCH_SIZE);
+	vector<int> roots;
+	vector<vector<int>> targets;
+
+	counter.start();
+	start = chrono::steady_clock::now();
+	for (size_t first = 0; first < queries.size(); first += BATCH_SIZE) {
+		size_t last = min(first + BATCH_SIZE, queries.size());
+		roots.clear();
+		targets.clear();
+		for (size_t q = first; q < last; q++) {
+			if (!batched)
+				graph.search<FifoQueue>(queries[q].first, queries[q].second,
+				                        INT_MAX, UnitWeight(), NoHeuristic());
+			roots.push_back(queries[q].first);
+			targets.push_back(vector<int>(1, queries[q].second));
+		}
+		if (batched) {
+			states.resize(roots.size());
+			graph.BFSBatch(states, roots, targets);
+		}
+	}
+	end = chrono::steady_clock::now();
+	long long misses = counter.stop();
+
+	chrono::duration<double> seconds = end - start;
+	cout << left << setw(8) << label << setw(10)
+	     << (batched ? "batch" + to_string(BATCH_SIZE) : string("topdown"))
+	     << right << setw(12) << fixed << setprecision(4) << seconds.count()
+	     << setw(16);
+	if (misses < 0)
+		cout << "n/a";
+	else
+		cout << misses;
+	cout << "\n";
+}
+
+/**
+ * Merges and connectivity checks of actorconnections, year by year: the
+ * consecutive actors of every movie of a year are merged, then each pair
+ * not connected yet is checked.
+ */
+struct MergeSequence {
+	int actors;                              // number of elements
+	vector<vector<pair<int,int>>> merges;    // merges of each year
+	vector<pair<int,int>> pairs;             // pairs checked every year
+};
+
+/**
+ * Replays a merge sequence with one disjoint set policy and prints one row
+ * of the matrix
+ * Parameters:
+ *      sequence: Merges and pairs to replay
+ *      compression: Name of the compression policy
+ *      link: Name of the union policy
+ *      storage: Name of the storage policy
+ *
+ */
+template<typename Compression, typename Union, typename Storage>
+void runDisjointSet(MergeSequence& sequence, const char * compression,
+                    const char * link, const char * storage) {
+	MissCounter counter;
+	chrono::time_point<chrono::steady_clock> start, end;
+	vector<int> connected(sequence.pairs.size(), -1); // year of each pair
+
+	counter.start();
+	start = chrono::steady_clock::now();
+	DisjointSet<Compression, Union, Storage> sets(sequence.actors);
+	for (int year = 0; year < (int)sequence.merges.size(); year++) {
+		for (auto & merge : sequence.merges[year])
+			sets.merge(merge.first, merge.second);
+		for (int p = 0; p < (int)sequence.pairs.size(); p++)
+			if (connected[p] < 0 && sets.find(sequence.pairs[p].first) ==
+			                            sets.find(sequence.pairs[p].second))
+				connected[p] = year;
+	}
+	end = chrono::steady_clock::now();
+	long long misses = counter.stop();
+
+	// every policy has to connect the same pairs in the same years
+	long long checksum = 0;
+	for (int p = 0; p < (int)connected.size(); p++)
+		checksum += (long long)(p + 1) * connected[p];
+
+	chrono::duration<double> seconds = end - start;
+	cout << left << setw(12) << compression << setw(8) << link << setw(8)
+	     << storage << right << setw(12) << fixed << setprecision(4)
+	     << seconds.count() << setw(16);
+	if (misses < 0)
+		cout << "n/a";
+	else
+		cout << misses;
+	cout << setw(16) << checksum << "\n";
+}
+
+/**
+ * Runs the three compression policies with one union and storage policy
+ * Parameters:
+ *      sequence: Merges and pairs to replay
+ *      link: Name of the union policy
+ *      storage: Name of the storage policy
+ *
+ */
+template<typename Union, typename Storage>
+void runCompressions(MergeSequence& sequence, const char * link,
+                                                     const char * storage) {
+	runDisjointSet<FullCompression, Union, Storage>(sequence, "full", link,
+	                                                                storage);
+	runDisjointSet<PathHalving, Union, Storage>(sequence, "halving", link,
+	                                                                storage);
+	runDisjointSet<PathSplitting, Union, Storage>(sequence, "splitting",
+	                                                          link, storage);
+}
+
+/**
+ * Runs every union and compression policy with one storage policy
+ * Parameters:
+ *      sequence: Merges and pairs to replay
+ *      storage: Name of the storage policy
+ *
+ */
+template<typename Storage>
+void runUnions(MergeSequence& sequence, const char * storage) {
+	runCompressions<UnionBySize, Storage>(sequence, "size", storage);
+	runCompressions<UnionByRank, Storage>(sequence, "rank", storage);
+	runCompressions<UnionByIndex, Storage>(sequence, "index", storage);
+}
+
+/**
+ * Times every disjoint set policy on the merges actorconnections makes
+ * for a cast file, with random pairs checked after every year
+ * Parameters:
+ *      movie_casts: Cast file
+ *      numQueries: Number of pairs checked
+ *      seed: Seed of the pairs
+ *
+ * Return: 0 on success, -1 if the file could not be read
+ */
+int benchDisjointSets(const char * movie_casts, int numQueries,
+                                                            unsigned seed) {
+	ActorGraph graph;
+	unordered_map<Movie, vector<int>> map;
+	if (!graph.loadFromFile(movie_casts, map))
+		return -1;
+
+	MergeSequence sequence;
+	sequence.actors = graph.size();
+	int first = INT_MAX, last = INT_MIN;
+	for (auto & movie : map) {
+		first = min(first, movie.first.movie_year);
+		last = max(last, movie.first.movie_year);
+	}
+	sequence.merges.resize(map.empty() ? 0 : last - first + 1);
+	for (auto & movie : map)
+		for (int i = 0; i + 1 < (int)movie.second.size(); i++)
+			sequence.merges[movie.first.movie_year - first].push_back(
+			                 make_pair(movie.second[i], movie.second[i + 1]));
+
+	mt19937 random(seed);
+	uniform_int_distribution<int> pick(0, max(graph.size() - 1, 0));
+	for (int q = 0; q < numQueries && graph.size(); q++)
+		sequence.pairs.push_back(make_pair(pick(random), pick(random)));
+
+	cout << left << setw(12) << "compression" << setw(8) << "union"
+	     << setw(8) << "storage" << right << setw(12) << "seconds"
+	     << setw(16) << "cache-misses" << setw(16) << "checksum" << "\n";
+	runUnions<PackedStorage>(sequence, "packed");
+	runUnions<PairStorage>(sequence, "pair");
+	return 0;
+}
+
+int main(int argc, const char ** argv){
+	// Checks for valid number of inputs
+	if (argc < NUM_ARGS) {
+		cerr << "Usage: graphbench movie_casts.tsv [--unionfind] [queries] "
+		        "[seed]" << endl;
+		return -1;
+	}
+
+	const char * movie_casts = argv[1];
+	bool unionFind = argc > 2 && !strcmp(argv[2], "--unionfind");
+	int shift = unionFind ? 1 : 0;
+	int numQueries = (argc > 2 + shift) ? atoi(argv[2 + shift])
+	                                    : DEFAULT_QUERIES;
+	unsigned seed = (argc > 3 + shift) ? atoi(argv[3 + shift]) : 1;
+
+	if (unionFind)
+		return benchDisjointSets(movie_casts, numQueries, seed);
+
+	const ActorOrder orders[] = { ORDER_NONE, ORDER_DEGREE, ORDER_RCM };
+	const char * labels[] = { "none", "degree", "rcm" };
+
+	// query pairs are drawn once by name so every ordering runs the same set
+	vector<pair<string,string>> names;
+
+	cout << left << setw(8) << "order" << setw(10) << "search" << right
+	     << setw(12) << "seconds" << setw(16) << "cache-misses" << "\n";
+
+	for (int i = 0; i < 3; i++) {
+		ActorGraph graph;
+		unordered_map<Movie, vector<int>> map;
+		if (!graph.loadFromFile(movie_casts, map))
+			return -1;
+		graph.createGraph(map);
+
+		if (names.empty()) {
+			mt19937 random(seed);
+			uniform_int_distribution<int> pick(0, graph.size() - 1);
+			for (int q = 0; q < numQueries; q++)
+				names.push_back(make_pair(
+				                      graph.nameOf(pick(random)),
+				                      graph.nameOf(pick(random))));
+		}
+
+		graph.reorder(orders[i]);
+
+		vector<pair<int,int>> queries;
+		for (auto & name : names)
+			queries.push_back(make_pair(graph.locateActor(name.first),
+			                            graph.locateActor(name.second)));
+
+		runQueries(graph, queries, labels[i], false);
+		runQueries(graph, queries, labels[i], true);
+		runTopDown(graph, queries, labels[i], false);
+		runTopDown(graph, queries, labels[i], true);
+	}
+
+	return 0;
+}
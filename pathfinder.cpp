@@ -8,9 +8,21 @@
  *
  */ 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #include "ActorGraph.h"
+#include "LabelIndex.h"
+#include "Landmarks.h"
+#include "SearchEngine.hpp"
+#include "VersionedGraph.h"
 #define NUM_ARGS 5
 using namespace std;
 
@@ -22,11 +34,93 @@ int main(int argc, const char ** argv){
     const char * out_filename = argv[4];
     
     // Checks for valid number of inputs
-    if (argc != NUM_ARGS) {
+    if (argc < NUM_ARGS) {
         cerr << "Wrong number of inputs into pathfinder" << endl;
     return -1;
 
     }
+
+    ActorOrder order = ORDER_NONE;    // vertex ordering applied after build
+    int numLandmarks = 0;             // landmarks for weighted A* queries
+    int maxYear = INT_MAX;            // latest movie year paths may use
+    int reference = DEFAULT_REFERENCE_YEAR; // year recency weights count from
+    bool plan = true;                 // one search per group of queries
+    const char * labelFile = NULL;    // hop label index for unweighted queries
+    vector<const char *> deltas;      // delta cast files added after build
+    int numThreads = 1;               // workers answering queries at once
+    const char * imageName = NULL;    // shared graph image to attach
+    const char * saveName = NULL;     // shared graph image to write
+    int interleave = 1;               // BFS searches run interleaved
+    long maxExpansions = 0;           // actors a search may expand, 0 for all
+    long deadlineMs = 0;              // milliseconds a search may take
+
+    // optional arguments following the four required ones
+    for (int i = NUM_ARGS; i < argc; i++) {
+        if (!strcmp(argv[i], "--reorder") && i + 1 < argc) {
+            const char * name = argv[++i];
+            if (!strcmp(name, "none"))
+                order = ORDER_NONE;
+            else if (!strcmp(name, "degree"))
+                order = ORDER_DEGREE;
+            else if (!strcmp(name, "rcm"))
+                order = ORDER_RCM;
+            else {
+                cerr << "Unknown ordering " << name << endl;
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--alt") && i + 1 < argc) {
+            numLandmarks = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--year") && i + 1 < argc) {
+            maxYear = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--reference") && i + 1 < argc) {
+            char * end;
+            long year = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end || year < INT_MIN || year > INT_MAX) {
+                cerr << "--reference needs a year" << endl;
+                return -1;
+            }
+            reference = year;
+        }
+        else if (!strcmp(argv[i], "--no-plan")) {
+            plan = false;
+        }
+        else if (!strcmp(argv[i], "--labels") && i + 1 < argc) {
+            labelFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--delta") && i + 1 < argc) {
+            deltas.push_back(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--image") && i + 1 < argc) {
+            imageName = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--save-image") && i + 1 < argc) {
+            saveName = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--interleave") && i + 1 < argc) {
+            interleave = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--max-expansions") && i + 1 < argc) {
+            maxExpansions = atol(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--deadline") && i + 1 < argc) {
+            deadlineMs = atol(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+            if (numThreads < 1 || numThreads >= READER_SLOTS) {
+                cerr << "--threads needs 1 to " << READER_SLOTS - 1
+                     << " workers" << endl;
+                return -1;
+            }
+        }
+        else {
+            cerr << "Unknown option " << argv[i] << endl;
+            return -1;
+        }
+    }
     
     // checks for valid input option
     if ( strcmp(edgeOption, "w") && strcmp(edgeOption, "u")) {
@@ -35,16 +129,138 @@ int main(int argc, const char ** argv){
     }
     
     bool use_weighted_edges = ( !strcmp(edgeOption, "w") ); // option 
+
+    // landmark bounds hold for the weights they were computed with only
+    if (numLandmarks > 0 && reference != DEFAULT_REFERENCE_YEAR) {
+        cerr << "--alt needs the default reference year "
+             << DEFAULT_REFERENCE_YEAR << endl;
+        return -1;
+    }
+
+    // batches interleave top-down BFS searches only
+    if (interleave < 1 || (interleave > 1 &&
+                                      (use_weighted_edges || labelFile))) {
+        cerr << "--interleave needs a positive batch size, unweighted edges "
+                "and no --labels" << endl;
+        return -1;
+    }
+
+    // the labels hold hop distances over every movie
+    if (labelFile && (use_weighted_edges || maxYear != INT_MAX)) {
+        cerr << "--labels needs unweighted edges and no --year" << endl;
+        return -1;
+    }
+    // the limits bound searches, a label query runs none
+    bool budgeted = maxExpansions > 0 || deadlineMs > 0;
+    if (maxExpansions < 0 || deadlineMs < 0 || (budgeted && labelFile)) {
+        cerr << "--max-expansions and --deadline need a positive limit and "
+                "no --labels" << endl;
+        return -1;
+    }
+
+    // an attached image was built, reordered and merged by its writer
+    if (imageName && (order != ORDER_NONE || !deltas.empty() || saveName)) {
+        cerr << "--image cannot be combined with --reorder, --delta or "
+                "--save-image" << endl;
+        return -1;
+    }
+
     ActorGraph graph;                                       // graph
-	unordered_map<Movie, vector <int>> map; // maps movie to all actors in movie
-    graph.loadFromFile(movie_casts, map);   // loads graph to map
-	graph.createGraph(map);     // creates graph from map 
+    if (imageName) {
+        // the cast file is not read, the image already holds the graph
+        if (!graph.attachImage(imageName)) {
+            cerr << "Failed to attach " << imageName << "!\n";
+            return -1;
+        }
+    }
+    else {
+	    unordered_map<Movie, vector <int>> map; // maps movie to all actors
+	    graph.loadFromFile(movie_casts, map);   // loads graph to map
+	    graph.createGraph(map);     // creates graph from map 
+	    graph.reorder(order);       // lays out actors for cache locality
+    }
+
+    // deltas are searchable at once, merged into a new version meanwhile
+    for (const char * delta : deltas) {
+        int added = graph.loadDelta(delta);
+        if (added < 0) {
+            cerr << "Failed to read " << delta << "!\n";
+            return -1;
+        }
+        cerr << "Added " << added << " movies from " << delta << endl;
+    }
+
+    // the merged graph is written once for other processes to attach
+    if (saveName) {
+        if (!graph.saveImage(saveName)) {
+            cerr << "Failed to write " << saveName << "!\n";
+            return -1;
+        }
+        deltas.clear();           // merged already, nothing to compact
+    }
+
+    // recency weights are only non-negative from the latest movie on, and
+    // the weighted searches settle an actor the first time it is popped
+    if (use_weighted_edges) {
+        int latest = INT_MIN;
+        for (int movie = 0; movie < graph.movieCount(); movie++)
+            latest = max(latest, graph.yearOf(movie));
+        if (reference < latest) {
+            cerr << "Reference year " << reference << " is before the "
+                 << "latest movie year " << latest << ", pass a later "
+                 << "--reference" << endl;
+            return -1;
+        }
+    }
+
+    // landmark preprocessing for goal directed weighted queries
+    Landmarks landmarks;
+    if (use_weighted_edges && numLandmarks > 0)
+        landmarks.build(graph, numLandmarks);
+
+    // hop labels are read back when they were saved for this graph
+    LabelIndex labels;
+    if (labelFile && !labels.load(labelFile, graph)) {
+        cerr << "Building label index " << labelFile << endl;
+        labels.build(graph);
+        if (!labels.save(labelFile))
+            cerr << "Failed to write " << labelFile << "!\n";
+    }
+
+    // the search is picked once here, each choice is its own instantiation.
+    // Searches only read the graph and write the state they are given.
+    function<void(const ActorGraph&, SearchState&, int,
+                  const vector<int>&)> findPaths;
+    if (!use_weighted_edges)
+        findPaths = [&](const ActorGraph& version, SearchState& state,
+                        int from, const vector<int>& targets){
+            version.BFSTraversal(state, from, targets, maxYear);
+        };
+    else if (landmarks.size())
+        findPaths = [&](const ActorGraph& version, SearchState& state,
+                        int from, const vector<int>& targets){
+            // the landmark bound heads for a single target only
+            if (targets.size() == 1)
+                version.search<HeapQueue>(state, from, targets, maxYear,
+                     RecencyWeight(), LandmarkHeuristic(landmarks, targets[0]));
+            else
+                version.search<HeapQueue>(state, from, targets, maxYear,
+                                          RecencyWeight(), NoHeuristic());
+        };
+    else
+        findPaths = [&](const ActorGraph& version, SearchState& state,
+                        int from, const vector<int>& targets){
+            version.search<HeapQueue>(state, from, targets, maxYear,
+                                    RecencyWeight(reference), NoHeuristic());
+        };
 
     
     // Initialize the file stream
     ifstream infile(in_filename);
-    ofstream outfile(out_filename);
+    OutputWriter outfile(out_filename);   // formats and writes in the back
     bool have_header = false;
+    vector<pair<string,string>> names;    // actor names of every query
+    vector<pair<int,int>> queries;        // actor indices of every query
 
 
 	// output header
@@ -82,28 +298,161 @@ int main(int argc, const char ** argv){
         }
         
         // stores inputs 
-        string fromActor(record[0]);
-        string toActor(record[1]);
+        names.push_back(make_pair(record[0], record[1]));
 
 		// index of the actors in the actor set
-		int fromIndex = graph.locateActor(fromActor);
-		int toIndex = graph.locateActor(toActor);
+		queries.push_back(make_pair(graph.locateActor(record[0]),
+		                            graph.locateActor(record[1])));
+    }
+
+    // queries sharing a root are answered by one search. Unweighted paths
+    // read the same both ways, so either endpoint may be the root and the
+    // one shared by more queries is picked; weighted paths start at the
+    // source so ties between equal paths break as they always have.
+    unordered_map<int, int> frequency;    // queries an actor is part of
+    for (auto & query : queries) {
+        if (query.first < 0 || query.second < 0)
+            continue;
+        frequency[query.first]++;
+        frequency[query.second]++;
+    }
 
-		cerr << "Computing path for (" << fromActor << ") -> (" << toActor
-                                                             << ")" << endl;
-        // Runs corresponding algorithm
-        if (use_weighted_edges){
-            graph.Dijkstra(fromIndex, toIndex);
-			graph.printConnections(fromIndex, toIndex, outfile, true);
+    vector<int> roots;                    // root of each group, first seen
+    vector<vector<int>> groups;           // queries of each group, in order
+    unordered_map<int, int> groupOf;      // root to index of its group
+    if (labels.size())
+        plan = false;                     // labels answer each query alone
+    for (int q = 0; q < (int)queries.size(); q++) {
+        int from = queries[q].first;
+        int to = queries[q].second;
+
+        // a name missing from the graph is answered here, never searched
+        if (from < 0 || to < 0) {
+            cerr << "Computing path for (" + names[q].first +
+                            ") -> (" + names[q].second + ")\n";
+            OutputBuffer result;
+            result << "Actor/actress ("
+                   << (from < 0 ? names[q].first : names[q].second)
+                   << ") not found!\n";
+            outfile.commit(q, result);
+            continue;
         }
-        else{ 
-            graph.BFSTraversal(fromIndex, toIndex);
-			graph.printConnections(fromIndex, toIndex, outfile, false);
+        int root = from;
+        if (plan && !use_weighted_edges && frequency[to] > frequency[from])
+            root = to;
+
+        auto found = groupOf.find(root);
+        if (!plan || found == groupOf.end()) {
+            groupOf[root] = groups.size();
+            roots.push_back(root);
+            groups.push_back(vector<int>());
+            found = groupOf.find(root);
         }
-        
-        // Prints all the movies and actors connecting two actors
+        groups[found->second].push_back(q);
     }
 
+    // the built graph is the first version; merging the deltas publishes
+    // the next one while the workers go on reading the first
+    VersionedGraph versions(&graph);
+    thread compactor;
+    if (!deltas.empty())
+        compactor = thread([&](){
+            versions.update([](ActorGraph& next){
+                next.compact();
+                return true;
+            });
+        });
+
+    // workers take batches of groups in turn, each pinning the current
+    // version for one batch and searching it with its own states
+    atomic<int> nextGroup(0);             // next group no worker took yet
+    int groupCount = groups.size();
+    atomic<int> stoppedSearches(0);       // searches that ran out of budget
+    atomic<int> unsettledQueries(0);      // queries answered over budget
+    auto answerGroups = [&](){
+        int slot = versions.attach();
+        vector<SearchState> states(interleave); // fields of each search
+        for (SearchState & state : states) {
+            state.maxExpansions = maxExpansions;
+            state.timeLimit = chrono::milliseconds(deadlineMs);
+        }
+        OutputBuffer result;              // formatted answer of one query
+        vector<int> batchRoots;           // root of each group of the batch
+        vector<vector<int>> batchTargets; // other endpoints of each group
+        vector<int> path;                 // actors of a label path
+        for (int first = nextGroup.fetch_add(interleave); first < groupCount;
+                                  first = nextGroup.fetch_add(interleave)) {
+            int last = min(first + interleave, groupCount);
+            PinnedGraph version(versions, slot);
+
+            // with labels a query is a merge of two labels, no search at all
+            if (labels.size()) {
+                int q = groups[first][0];
+                cerr << "Computing path for (" + names[q].first +
+                                ") -> (" + names[q].second + ")\n";
+                result.clear();
+                if (labels.path(queries[q].first, queries[q].second, path))
+                    version->printPath(path, result, false);
+                else
+                    result << "Actors/actresses not connected!\n";
+                outfile.commit(q, result);
+                continue;
+            }
+
+            batchRoots.assign(roots.begin() + first, roots.begin() + last);
+            batchTargets.assign(last - first, vector<int>());
+            for (int g = first; g < last; g++) {
+                for (int q : groups[g]) {
+                    cerr << "Computing path for (" + names[q].first +
+                                    ") -> (" + names[q].second + ")\n";
+                    batchTargets[g - first].push_back(
+                                          queries[q].first == roots[g]
+                                          ? queries[q].second
+                                          : queries[q].first);
+                }
+            }
+
+            // Runs corresponding algorithm
+            if (interleave > 1)
+                version->BFSBatch(states, batchRoots, batchTargets, maxYear);
+            else
+                findPaths(*version, states[0], batchRoots[0],
+                                                       batchTargets[0]);
+
+            // Prints all the movies and actors connecting two actors
+            for (int g = first; g < last; g++) {
+                if (states[g - first].exceeded)
+                    stoppedSearches++;
+                for (int q : groups[g]) {
+                    int from = queries[q].first;
+                    int to = queries[q].second;
+                    if (!version->settled(states[g - first], from, to,
+                                      use_weighted_edges, from != roots[g]))
+                        unsettledQueries++;
+                    result.clear();
+                    version->printConnections(states[g - first], from, to,
+                          result, use_weighted_edges, maxYear, from != roots[g]);
+                    outfile.commit(q, result);
+                }
+            }
+        }
+        versions.detach(slot);
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++)
+        workers.push_back(thread(answerGroups));
+    answerGroups();
+    for (thread & worker : workers)
+        worker.join();
+    if (compactor.joinable())
+        compactor.join();
+
+    if (budgeted)
+        cerr << "Search budget exceeded by " << stoppedSearches << " of "
+             << groupCount << " searches, " << unsettledQueries << " of "
+             << queries.size() << " queries unanswered" << endl;
+
 
     if (!infile.eof()) {
         cerr << "Failed to read " << in_filename << "!\n";
@@ -112,7 +461,10 @@ int main(int argc, const char ** argv){
     
     // closes streams 
     infile.close();
-    outfile.close();
+    if (!outfile.close()) {
+        cerr << "Failed to write " << out_filename << "!\n";
+        return -1;
+    }
 
 
     return 0;